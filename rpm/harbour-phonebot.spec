@@ -48,7 +48,8 @@ built to pass harbour.
 # << build pre
 
 %qtc_qmake5  \
-    CONFIG+=harbour
+    CONFIG+=harbour \
+    PHONEBOT_LOG_LEVEL=warning
 
 %qtc_make %{?_smp_mflags}
 
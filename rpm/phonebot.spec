@@ -43,7 +43,8 @@ triggers. This package contains the daemon.
 # >> build pre
 # << build pre
 
-%qtc_qmake5 
+%qtc_qmake5  \
+    PHONEBOT_LOG_LEVEL=warning
 
 %qtc_make %{?_smp_mflags}
 
@@ -62,5 +63,6 @@ rm -rf %{buildroot}
 %files
 %defattr(-,root,root,-)
 %{_bindir}/%{name}d
+%{_bindir}/%{name}-journal
 # >> files
 # << files
@@ -1,5 +1,5 @@
 TEMPLATE = subdirs
 !CONFIG(coverage): {
-    !CONFIG(harbour): SUBDIRS += daemon
+    !CONFIG(harbour): SUBDIRS += daemon journal replay standin rulegen loaddriver
     CONFIG(harbour): SUBDIRS += harbour
 }
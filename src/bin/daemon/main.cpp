@@ -29,8 +29,11 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
  */
 
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QtPlugin>
+#include <phonebotengine.h>
+#include <triggerrecorder.h>
 #include "enginemanager.h"
 
 Q_IMPORT_PLUGIN(PhoneBotDebugPlugin)
@@ -46,10 +49,33 @@ int main(int argc, char **argv)
     app.setOrganizationName("phonebot");
     app.setApplicationName("phonebotd");
 
-    EngineManager manager;
-    manager.reloadEngine();
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption workersOption ("workers", "Number of engines evaluating the rules, each "
+                                      "additional engine running in its own thread.", "count", "1");
+    parser.addOption(workersOption);
+    QCommandLineOption traceOption ("record-trace", "Record the events of the triggers to <trace>, "
+                                    "so that they can be replayed with phonebot-replay.", "trace");
+    parser.addOption(traceOption);
+    parser.process(app);
 
-    QObject::connect(&app, &QCoreApplication::aboutToQuit, &manager, &EngineManager::stop);
+    if (parser.isSet(traceOption) && !TriggerRecorder::open(parser.value(traceOption))) {
+        return 1;
+    }
 
-    return app.exec();
+    int result = 0;
+    {
+        EngineManager manager;
+        manager.setWorkerCount(parser.value(workersOption).toInt());
+        manager.reloadEngine();
+
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, &manager, &EngineManager::stop);
+
+        result = app.exec();
+        TriggerRecorder::close();
+    }
+
+    // Engines, including the ones of the workers, are destroyed
+    PhoneBotEngine::deleteStaticPlugins();
+    return result;
 }
@@ -0,0 +1,16 @@
+TEMPLATE = app
+TARGET = phonebot-journal
+
+QT = core
+
+include(../../config.pri)
+
+INCLUDEPATH += ../../lib/core
+
+SOURCES = \
+    main.cpp
+
+!CONFIG(harbour) {
+    target.path = /usr/bin
+    INSTALLS += target
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+#include <algorithm>
+#include <executionjournalformat.h>
+
+static const char *JOURNAL_FILE = "journal.bin";
+static const qint64 NSECS_PER_MSEC = 1000000;
+
+// Fields of a JournalRecord, copied out of the ring
+struct RecordCopy
+{
+    quint64 time;
+    quint32 rule;
+    quint32 duration;
+    quint16 kind;
+    quint16 index;
+    quint16 result;
+    quint16 flags;
+};
+
+static QString kindName(quint16 kind)
+{
+    switch (kind) {
+    case JournalTriggerFired:
+        return "trigger";
+    case JournalConditionChecked:
+        return "condition";
+    case JournalActionExecuted:
+        return "action";
+    default:
+        return "unknown";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+    // Same locations as the daemon
+    app.setOrganizationName("phonebot");
+    app.setApplicationName("phonebotd");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decodes the execution journal written by phonebotd.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("journal", "Path to the journal, defaults to the one of phonebotd.");
+    QCommandLineOption ruleOption ("rule", "Only show records of rules whose path contains <rule>.", "rule");
+    parser.addOption(ruleOption);
+    parser.process(app);
+
+    QString path = parser.positionalArguments().value(0);
+    if (path.isEmpty()) {
+        QDir dataRoot (QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+        path = dataRoot.absoluteFilePath(JOURNAL_FILE);
+    }
+
+    QTextStream out (stdout);
+    QTextStream err (stderr);
+    QFile file (path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err << "Cannot open " << path << endl;
+        return 1;
+    }
+
+    // The journal is mapped read-only, so that it can be decoded while the daemon runs
+    uchar *data = file.map(0, file.size());
+    if (!data || file.size() < qint64(sizeof(JournalHeader))) {
+        err << "Cannot read " << path << endl;
+        return 1;
+    }
+
+    const JournalHeader *header = reinterpret_cast<const JournalHeader *>(data);
+    if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION
+        || header->recordSize != sizeof(JournalRecord)) {
+        err << path << " is not a journal in a supported format" << endl;
+        return 1;
+    }
+
+    qint64 expected = sizeof(JournalHeader) + qint64(header->nameSlots) * sizeof(JournalName)
+                      + qint64(header->capacity) * sizeof(JournalRecord);
+    if (file.size() < expected || header->capacity == 0) {
+        err << path << " is truncated" << endl;
+        return 1;
+    }
+
+    const JournalName *names = reinterpret_cast<const JournalName *>(data + sizeof(JournalHeader));
+    QHash<quint32, QString> ruleNames;
+    for (quint32 i = 0; i < header->nameSlots; ++i) {
+        if (names[i].id != 0) {
+            int size = qstrnlen(names[i].name, JOURNAL_NAME_SIZE);
+            ruleNames.insert(names[i].id, QString::fromUtf8(names[i].name, size));
+        }
+    }
+
+    // Only the last capacity records are still in the ring. Records
+    // whose sequence does not match are being written, or were overwritten.
+    // The journal might be live, so each record is copied, and dropped
+    // if its sequence changed while it was copied.
+    const uchar *recordData = data + sizeof(JournalHeader) + header->nameSlots * sizeof(JournalName);
+    const JournalRecord *records = reinterpret_cast<const JournalRecord *>(recordData);
+    quint64 writeIndex = header->writeIndex.load(std::memory_order_acquire);
+    quint64 first = writeIndex > header->capacity ? writeIndex - header->capacity : 0;
+    QString filter = parser.value(ruleOption);
+    int count = 0;
+    for (quint64 sequence = first; sequence < writeIndex; ++sequence) {
+        const JournalRecord &slot = records[sequence % header->capacity];
+        if (slot.sequence.load(std::memory_order_acquire) != sequence + 1) {
+            continue;
+        }
+
+        RecordCopy record;
+        record.time = slot.time;
+        record.rule = slot.rule;
+        record.duration = slot.duration;
+        record.kind = slot.kind;
+        record.index = slot.index;
+        record.result = slot.result;
+        record.flags = slot.flags;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence + 1) {
+            continue;
+        }
+
+        QString rule = ruleNames.value(record.rule, QString("#%1").arg(record.rule, 8, 16, QChar('0')));
+        if (!filter.isEmpty() && !rule.contains(filter)) {
+            continue;
+        }
+
+        QDateTime time = QDateTime::fromMSecsSinceEpoch(record.time / NSECS_PER_MSEC);
+        out << time.toString("yyyy-MM-dd hh:mm:ss.zzz") << " "
+            << kindName(record.kind).leftJustified(9) << " ";
+        if (record.kind == JournalActionExecuted) {
+            out << "#" << record.index << " ";
+        }
+        if (record.kind != JournalTriggerFired) {
+            out << (record.result ? "ok" : "failed") << " "
+                << (record.flags & JOURNAL_DURATION_SATURATED ? ">" : "")
+                << QString::number(record.duration / 1000.) << "us ";
+        }
+        out << rule << endl;
+        ++count;
+    }
+
+    err << count << " records, " << writeIndex << " written since the journal was created" << endl;
+    if (header->droppedNames > 0) {
+        err << header->droppedNames << " rule names did not fit in the name table, "
+            << "their records show the id of the rule" << endl;
+    }
+    file.unmap(data);
+    return 0;
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "loaddriver.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusConnectionInterface>
+#include <QtDBus/QDBusServiceWatcher>
+#include <algorithm>
+#include "proxy.h"
+
+static const char *SERVICE = "org.SfietKonstantin.phonebot";
+static const char *PATH = "/";
+static const char *CONFIG_DIR = "phonebot/phonebotd";
+static const int STOP_TIMEOUT = 5000;
+
+static qint64 percentile(QVector<qint64> values, int percent)
+{
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values.at((values.count() - 1) * percent / 100);
+}
+
+static qint64 mean(const QVector<qint64> &values)
+{
+    if (values.isEmpty()) {
+        return 0;
+    }
+    qint64 sum = 0;
+    for (qint64 value : values) {
+        sum += value;
+    }
+    return sum / values.count();
+}
+
+LoadDriver::LoadDriver(QObject *parent)
+    : QObject(parent), m_daemon("phonebotd"), m_workerCount(0), m_reloadCount(10)
+    , m_timeout(60000), m_process(new QProcess(this)), m_watcher(0), m_proxy(0)
+    , m_timeoutTimer(new QTimer(this)), m_started(false), m_reloading(false)
+    , m_reloadStarted(false), m_finished(false), m_ruleCount(0), m_startupTime(0)
+    , m_startupRss(0), m_finalRss(0), m_peakRss(0)
+{
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &LoadDriver::slotTimeout);
+    connect(m_process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(slotProcessFinished()));
+}
+
+void LoadDriver::setDaemon(const QString &daemon)
+{
+    m_daemon = daemon;
+}
+
+void LoadDriver::setWorkerCount(int workerCount)
+{
+    m_workerCount = workerCount;
+}
+
+void LoadDriver::setReloadCount(int reloadCount)
+{
+    m_reloadCount = reloadCount;
+}
+
+void LoadDriver::setTimeout(int timeout)
+{
+    m_timeout = timeout;
+}
+
+bool LoadDriver::start(const QString &rules)
+{
+    QDir rulesDir (rules);
+    if (!rulesDir.exists()) {
+        m_errorString = QString("%1 does not exist").arg(rules);
+        return false;
+    }
+
+    // The daemon looks for rules in $XDG_CONFIG_HOME/phonebot/phonebotd
+    QDir home (m_home.path());
+    if (!m_home.isValid() || !home.mkpath("config/phonebot") || !home.mkpath("data")) {
+        m_errorString = "Failed to create a temporary home";
+        return false;
+    }
+    QString configDir = QDir(home.absoluteFilePath("config")).absoluteFilePath(CONFIG_DIR);
+    if (!QFile::link(rulesDir.absolutePath(), configDir)) {
+        m_errorString = QString("Failed to link %1 to %2").arg(rulesDir.absolutePath(), configDir);
+        return false;
+    }
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        m_errorString = "Failed to connect to the session bus";
+        return false;
+    }
+    if (bus.interface()->isServiceRegistered(SERVICE)) {
+        m_errorString = QString("%1 is already registered, use a private bus").arg(SERVICE);
+        return false;
+    }
+
+    m_watcher = new QDBusServiceWatcher(SERVICE, bus, QDBusServiceWatcher::WatchForRegistration, this);
+    connect(m_watcher, &QDBusServiceWatcher::serviceRegistered, this, &LoadDriver::slotServiceRegistered);
+    m_proxy = new OrgSfietKonstantinPhonebotInterface(SERVICE, PATH, bus, this);
+    connect(m_proxy, &OrgSfietKonstantinPhonebotInterface::ReadyChanged,
+            this, &LoadDriver::slotReadyChanged);
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("XDG_CONFIG_HOME", home.absoluteFilePath("config"));
+    environment.insert("XDG_DATA_HOME", home.absoluteFilePath("data"));
+    m_process->setProcessEnvironment(environment);
+    m_process->setStandardOutputFile(QProcess::nullDevice());
+    m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    QStringList arguments;
+    if (m_workerCount > 0) {
+        arguments << "--workers" << QString::number(m_workerCount);
+    }
+
+    m_elapsedTimer.start();
+    m_timeoutTimer->start(m_timeout);
+    m_process->start(m_daemon, arguments);
+    if (!m_process->waitForStarted()) {
+        m_errorString = QString("Failed to start %1: %2").arg(m_daemon, m_process->errorString());
+        return false;
+    }
+    return true;
+}
+
+bool LoadDriver::hasError() const
+{
+    return !m_errorString.isEmpty();
+}
+
+QString LoadDriver::errorString() const
+{
+    return m_errorString;
+}
+
+QVariantMap LoadDriver::metrics() const
+{
+    QVariantMap metrics;
+    metrics.insert("rules", m_ruleCount);
+    metrics.insert("startupTime", m_startupTime);
+    metrics.insert("startupRss", m_startupRss);
+    metrics.insert("finalRss", m_finalRss);
+    metrics.insert("peakRss", m_peakRss);
+    metrics.insert("reloads", m_reloadTimes.count());
+    metrics.insert("meanReloadTime", mean(m_reloadTimes));
+    metrics.insert("p50ReloadTime", percentile(m_reloadTimes, 50));
+    metrics.insert("p99ReloadTime", percentile(m_reloadTimes, 99));
+    metrics.insert("maxReloadTime", percentile(m_reloadTimes, 100));
+    metrics.insert("maxReloadOverlap", percentile(m_reloadOverlaps, 100));
+    return metrics;
+}
+
+void LoadDriver::slotServiceRegistered()
+{
+    // The daemon might have been ready before the
+    // ReadyChanged signal could be received
+    if (!m_started && m_proxy->IsReady().value()) {
+        slotReadyChanged(true);
+    }
+}
+
+void LoadDriver::slotReadyChanged(bool ready)
+{
+    if (m_finished) {
+        return;
+    }
+
+    if (!m_started) {
+        if (ready) {
+            m_started = true;
+            m_startupTime = m_elapsedTimer.elapsed();
+            m_startupRss = memoryUsage("VmRSS");
+            m_ruleCount = m_proxy->Rules().value().count();
+            startReload();
+        }
+        return;
+    }
+
+    if (!m_reloading) {
+        return;
+    }
+
+    // Running rules are replaced by staged ones, the
+    // daemon is ready again once they are swapped
+    if (!ready) {
+        m_reloadStarted = true;
+    } else if (m_reloadStarted) {
+        m_reloadTimes.append(m_elapsedTimer.elapsed());
+        m_reloadOverlaps.append(m_proxy->LastReloadOverlap().value());
+        startReload();
+    }
+}
+
+void LoadDriver::slotProcessFinished()
+{
+    finish(QString("%1 exited before the end of the run").arg(m_daemon));
+}
+
+void LoadDriver::slotTimeout()
+{
+    finish(QString("Timed out after %1ms").arg(m_timeout));
+}
+
+void LoadDriver::startReload()
+{
+    if (m_reloadTimes.count() >= m_reloadCount) {
+        finish();
+        return;
+    }
+
+    m_reloading = true;
+    m_reloadStarted = false;
+    m_timeoutTimer->start(m_timeout);
+    m_elapsedTimer.restart();
+    m_proxy->ReloadEngine();
+}
+
+void LoadDriver::finish(const QString &error)
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_errorString = error;
+    m_timeoutTimer->stop();
+
+    if (m_process->state() == QProcess::Running) {
+        m_finalRss = memoryUsage("VmRSS");
+        m_peakRss = memoryUsage("VmHWM");
+        m_process->disconnect(this);
+        m_process->terminate();
+        if (!m_process->waitForFinished(STOP_TIMEOUT)) {
+            m_process->kill();
+            m_process->waitForFinished(STOP_TIMEOUT);
+        }
+    }
+    emit finished();
+}
+
+qint64 LoadDriver::memoryUsage(const char *key) const
+{
+    QFile file (QString("/proc/%1/status").arg(m_process->processId()));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // Lines are formatted as "VmRSS:     1234 kB"
+    QTextStream stream (&file);
+    QString prefix = QString("%1:").arg(key);
+    QString line = stream.readLine();
+    while (!line.isNull()) {
+        if (line.startsWith(prefix)) {
+            return line.mid(prefix.length()).trimmed().section(' ', 0, 0).toLongLong();
+        }
+        line = stream.readLine();
+    }
+    return -1;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef LOADDRIVER_H
+#define LOADDRIVER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+class QTimer;
+class QDBusServiceWatcher;
+class OrgSfietKonstantinPhonebotInterface;
+
+// Drives phonebotd against a set of rules
+//
+// The daemon is started with a temporary configuration folder that
+// links to the rules, and is exercised through its D-Bus interface.
+// The time until the daemon is ready, its memory usage and the
+// latency of reloading the rules are measured.
+//
+// The daemon registers itself on the session bus, so the driver
+// should run on a private bus, for example with run-standin.sh.
+class LoadDriver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LoadDriver(QObject *parent = 0);
+    void setDaemon(const QString &daemon);
+    void setWorkerCount(int workerCount);
+    void setReloadCount(int reloadCount);
+    void setTimeout(int timeout);
+    bool start(const QString &rules);
+    bool hasError() const;
+    QString errorString() const;
+    QVariantMap metrics() const;
+Q_SIGNALS:
+    void finished();
+private Q_SLOTS:
+    void slotServiceRegistered();
+    void slotReadyChanged(bool ready);
+    void slotProcessFinished();
+    void slotTimeout();
+private:
+    void startReload();
+    void finish(const QString &error = QString());
+    qint64 memoryUsage(const char *key) const; // In kB, from /proc/<pid>/status
+    QString m_daemon;
+    int m_workerCount;
+    int m_reloadCount;
+    int m_timeout;
+    QTemporaryDir m_home;
+    QProcess *m_process;
+    QDBusServiceWatcher *m_watcher;
+    OrgSfietKonstantinPhonebotInterface *m_proxy;
+    QTimer *m_timeoutTimer;
+    QElapsedTimer m_elapsedTimer;
+    bool m_started;
+    bool m_reloading;
+    bool m_reloadStarted;
+    bool m_finished;
+    int m_ruleCount;
+    qint64 m_startupTime; // In msecs
+    qint64 m_startupRss;
+    qint64 m_finalRss;
+    qint64 m_peakRss;
+    QVector<qint64> m_reloadTimes; // In msecs
+    QVector<qint64> m_reloadOverlaps; // In usecs
+    QString m_errorString;
+};
+
+#endif // LOADDRIVER_H
@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = phonebot-loaddriver
+
+QT = core dbus
+
+include(../../config.pri)
+
+INCLUDEPATH += ../../lib/config
+
+LIBS += -L../../lib/config -lphonebotconfig
+
+HEADERS = \
+    loaddriver.h
+
+SOURCES = \
+    main.cpp \
+    loaddriver.cpp
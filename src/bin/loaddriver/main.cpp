@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
+#include "loaddriver.h"
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Starts phonebotd against a set of rules, and reports its "
+                                     "startup time, memory usage and reload latency.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("rules", "Folder containing rule_<n>/rule.qml, as written "
+                                 "by phonebot-rulegen.");
+    QCommandLineOption daemonOption ("daemon", "Daemon to start.", "daemon", "phonebotd");
+    QCommandLineOption workersOption ("workers", "Number of engines evaluating the rules.",
+                                      "workers");
+    QCommandLineOption reloadsOption ("reloads", "Number of reloads to measure.", "reloads", "10");
+    QCommandLineOption timeoutOption ("timeout", "Timeout of the startup and of each reload, "
+                                      "in msecs.", "timeout", "60000");
+    QCommandLineOption jsonOption ("json", "Output the metrics as JSON.");
+    parser.addOption(daemonOption);
+    parser.addOption(workersOption);
+    parser.addOption(reloadsOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(jsonOption);
+    parser.process(app);
+
+    QStringList arguments = parser.positionalArguments();
+    if (arguments.count() != 1) {
+        parser.showHelp(1);
+    }
+
+    LoadDriver driver;
+    driver.setDaemon(parser.value(daemonOption));
+    driver.setWorkerCount(parser.value(workersOption).toInt());
+    driver.setReloadCount(parser.value(reloadsOption).toInt());
+    driver.setTimeout(parser.value(timeoutOption).toInt());
+    QObject::connect(&driver, &LoadDriver::finished, &app, &QCoreApplication::quit);
+    if (!driver.start(arguments.first())) {
+        QTextStream(stderr) << driver.errorString() << endl;
+        return 1;
+    }
+    app.exec();
+
+    if (driver.hasError()) {
+        QTextStream(stderr) << driver.errorString() << endl;
+        return 1;
+    }
+
+    QTextStream out (stdout);
+    QVariantMap metrics = driver.metrics();
+    if (parser.isSet(jsonOption)) {
+        out << QJsonDocument(QJsonObject::fromVariantMap(metrics)).toJson();
+        return 0;
+    }
+
+    out << metrics.value("rules").toInt() << " rules ready in "
+        << metrics.value("startupTime").toLongLong() << "ms" << endl;
+    out << "RSS: " << metrics.value("startupRss").toLongLong() << "kB after startup, "
+        << metrics.value("finalRss").toLongLong() << "kB at the end, "
+        << metrics.value("peakRss").toLongLong() << "kB peak" << endl;
+    out << metrics.value("reloads").toInt() << " reloads: mean "
+        << metrics.value("meanReloadTime").toLongLong() << "ms, p50 "
+        << metrics.value("p50ReloadTime").toLongLong() << "ms, p99 "
+        << metrics.value("p99ReloadTime").toLongLong() << "ms, max "
+        << metrics.value("maxReloadTime").toLongLong() << "ms, longest overlap "
+        << metrics.value("maxReloadOverlap").toLongLong() << "us" << endl;
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
+#include <QtCore/QtPlugin>
+#include <phonebotengine.h>
+#include "replaydriver.h"
+
+Q_IMPORT_PLUGIN(PhoneBotDebugPlugin)
+Q_IMPORT_PLUGIN(PhoneBotProfilePlugin)
+Q_IMPORT_PLUGIN(PhoneBotTimePlugin)
+Q_IMPORT_PLUGIN(PhoneBotConnmanPlugin)
+Q_IMPORT_PLUGIN(PhoneBotAmbiencePlugin)
+Q_IMPORT_PLUGIN(PhoneBotNotificationsPlugin)
+
+static const char *RULE_FILE = "rule.qml";
+static const qint64 NSECS_PER_USEC = 1000;
+
+// Rules are either given as files, or as a folder laid out like the
+// configuration folder of the daemon, with a rule_<n>/rule.qml per rule
+static QStringList ruleFiles(const QStringList &paths)
+{
+    QStringList files;
+    for (const QString &path : paths) {
+        QDir dir (path);
+        if (!dir.exists()) {
+            files.append(path);
+            continue;
+        }
+        for (const QString &entry : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+            QString file = QDir(dir.absoluteFilePath(entry)).absoluteFilePath(RULE_FILE);
+            if (QFile::exists(file)) {
+                files.append(file);
+            }
+        }
+    }
+    return files;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays a trigger trace recorded with phonebotd --record-trace "
+                                     "against a set of rules, and reports per-rule metrics.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "Trace to replay.");
+    parser.addPositionalArgument("rules", "Rule files, or folders containing rule_<n>/rule.qml.",
+                                 "rules...");
+    QCommandLineOption speedOption ("speed", "Replay speed, relative to the recording. "
+                                    "0 replays as fast as possible.", "speed", "1000");
+    QCommandLineOption jsonOption ("json", "Output the metrics as JSON.");
+    parser.addOption(speedOption);
+    parser.addOption(jsonOption);
+    parser.process(app);
+
+    QStringList arguments = parser.positionalArguments();
+    if (arguments.count() < 2) {
+        parser.showHelp(1);
+    }
+
+    QStringList rules = ruleFiles(arguments.mid(1));
+    if (rules.isEmpty()) {
+        QTextStream(stderr) << "No rule to replay the trace against" << endl;
+        return 1;
+    }
+
+    PhoneBotEngine::registerTypes();
+    ReplayDriver driver;
+    driver.setSpeed(parser.value(speedOption).toDouble());
+    QObject::connect(&driver, &ReplayDriver::finished, &app, &QCoreApplication::quit);
+    if (!driver.load(arguments.first(), rules)) {
+        return 1;
+    }
+    app.exec();
+
+    QTextStream out (stdout);
+    QVariantMap metrics = driver.metrics();
+    if (parser.isSet(jsonOption)) {
+        QVariantMap result;
+        result.insert("replayed", driver.replayedCount());
+        result.insert("unmatched", driver.unmatchedCount());
+        result.insert("elapsed", driver.elapsed());
+        result.insert("simulated", driver.simulatedTime());
+        result.insert("rules", metrics);
+        out << QJsonDocument(QJsonObject::fromVariantMap(result)).toJson();
+        return 0;
+    }
+
+    out << driver.replayedCount() << " events replayed, " << driver.unmatchedCount()
+        << " without matching rule, " << driver.simulatedTime() << "ms simulated in "
+        << driver.elapsed() << "ms" << endl;
+    out << "events".rightJustified(8) << "mean(us)".rightJustified(10)
+        << "p99(us)".rightJustified(10) << "max(us)".rightJustified(10)
+        << "dropped".rightJustified(9) << "overruns".rightJustified(10) << " rule" << endl;
+    for (QVariantMap::const_iterator i = metrics.constBegin(); i != metrics.constEnd(); ++i) {
+        QVariantMap rule = i.value().toMap();
+        out << QString::number(rule.value("events").toLongLong()).rightJustified(8)
+            << QString::number(rule.value("meanTime").toLongLong() / NSECS_PER_USEC).rightJustified(10)
+            << QString::number(rule.value("p99Time").toLongLong() / NSECS_PER_USEC).rightJustified(10)
+            << QString::number(rule.value("maxTime").toLongLong() / NSECS_PER_USEC).rightJustified(10)
+            << QString::number(rule.value("dropped").toInt()).rightJustified(9)
+            << QString::number(rule.value("scriptOverruns").toInt()).rightJustified(10)
+            << " " << i.key() << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = phonebot-replay
+
+QT = core dbus qml
+
+include(../../config.pri)
+include(../libs.pri)
+
+INCLUDEPATH += ../../lib/core \
+    ../../lib/meta \
+    ../../lib/daemon
+
+HEADERS = \
+    replaydriver.h
+
+SOURCES = \
+    main.cpp \
+    replaydriver.cpp
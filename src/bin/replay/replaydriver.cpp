@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "replaydriver.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <engineworker.h>
+#include <metatypecache.h>
+#include <phonebotengine.h>
+#include <rule.h>
+#include <trigger.h>
+#include <virtualclock.h>
+
+static const int BATCH_SIZE = 256;
+static const char *EVENTS_KEY = "events";
+static const char *TOTAL_TIME_KEY = "totalTime";
+static const char *MEAN_TIME_KEY = "meanTime";
+static const char *P50_TIME_KEY = "p50Time";
+static const char *P99_TIME_KEY = "p99Time";
+static const char *MAX_TIME_KEY = "maxTime";
+static const char *DROPPED_KEY = "dropped";
+static const char *COALESCED_KEY = "coalesced";
+static const char *SCRIPT_OVERRUNS_KEY = "scriptOverruns";
+
+static qint64 percentile(const QVector<qint64> &sorted, int percent)
+{
+    if (sorted.isEmpty()) {
+        return 0;
+    }
+    return sorted.at(qMin(sorted.count() - 1, sorted.count() * percent / 100));
+}
+
+ReplayDriver::ReplayDriver(QObject *parent)
+    : QObject(parent), m_speed(1000.), m_clock(0), m_engine(0), m_typeCache(0), m_timer(0)
+    , m_hasNext(false), m_started(false), m_firstTimestamp(-1), m_replayed(0), m_unmatched(0)
+    , m_elapsed(0)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(slotReplay()));
+}
+
+void ReplayDriver::setSpeed(double speed)
+{
+    m_speed = qMax(0., speed);
+}
+
+QString ReplayDriver::ruleKey(const QString &path)
+{
+    // Rules are stored as rule_<n>/rule.qml by the daemon
+    QFileInfo info (path);
+    return QString("%1/%2").arg(info.dir().dirName(), info.fileName());
+}
+
+bool ReplayDriver::load(const QString &trace, const QStringList &rules)
+{
+    if (!m_reader.open(trace)) {
+        qWarning() << m_reader.errorString();
+        return false;
+    }
+
+    // The clock is installed before the rules are created,
+    // so that their timers are bound to it
+    m_hasNext = m_reader.readNext(m_next);
+    if (m_hasNext) {
+        m_firstTimestamp = m_next.timestamp;
+    }
+    QDateTime start = m_hasNext ? QDateTime::fromMSecsSinceEpoch(m_firstTimestamp)
+                                : QDateTime::currentDateTime();
+    m_clock = new VirtualClock(start, this);
+    Clock::setInstance(m_clock);
+
+    // Rules are executed directly, so that fire() covers the conditions
+    // and actions, and events fired in a batch are not coalesced
+    m_engine = EngineWorker::createEngine(this);
+    m_engine->setDispatchEnabled(false);
+    m_typeCache = MetaTypeCache::instance();
+    connect(m_engine, SIGNAL(componentLoadingFinished(QUrl,bool)),
+            this, SLOT(slotComponentLoadingFinished(QUrl,bool)));
+    connect(m_engine, SIGNAL(readyChanged()), this, SLOT(slotEngineReadyChanged()));
+
+    for (const QString &rule : rules) {
+        QUrl source = QUrl::fromLocalFile(QFileInfo(rule).absoluteFilePath());
+        m_rules.insert(ruleKey(source.toLocalFile()), source);
+        if (EngineWorker::addRule(m_engine, source, m_typeCache)) {
+            m_loading.insert(source);
+        } else {
+            qWarning() << "Failed to load" << rule;
+        }
+    }
+
+    if (m_loading.isEmpty()) {
+        m_engine->start();
+        slotEngineReadyChanged();
+    }
+    return true;
+}
+
+qint64 ReplayDriver::replayedCount() const
+{
+    return m_replayed;
+}
+
+qint64 ReplayDriver::unmatchedCount() const
+{
+    return m_unmatched;
+}
+
+qint64 ReplayDriver::elapsed() const
+{
+    return m_elapsed;
+}
+
+qint64 ReplayDriver::simulatedTime() const
+{
+    if (m_firstTimestamp == -1) {
+        return 0;
+    }
+    return m_next.timestamp - m_firstTimestamp;
+}
+
+QVariantMap ReplayDriver::metrics() const
+{
+    QVariantMap metrics;
+    for (QHash<QString, RuleMetrics>::const_iterator i = m_metrics.constBegin();
+         i != m_metrics.constEnd(); ++i) {
+        QVector<qint64> times = i.value().times;
+        std::sort(times.begin(), times.end());
+
+        QVariantMap ruleMetrics;
+        ruleMetrics.insert(EVENTS_KEY, i.value().events);
+        ruleMetrics.insert(TOTAL_TIME_KEY, i.value().totalTime);
+        ruleMetrics.insert(MEAN_TIME_KEY, i.value().events > 0 ? i.value().totalTime / i.value().events : 0);
+        ruleMetrics.insert(P50_TIME_KEY, percentile(times, 50));
+        ruleMetrics.insert(P99_TIME_KEY, percentile(times, 99));
+        ruleMetrics.insert(MAX_TIME_KEY, times.isEmpty() ? 0 : times.last());
+
+        Rule *rule = m_engine ? m_engine->rule(m_rules.value(i.key())) : 0;
+        if (rule) {
+            ruleMetrics.insert(DROPPED_KEY, rule->droppedCount());
+            ruleMetrics.insert(COALESCED_KEY, rule->coalescedCount());
+            ruleMetrics.insert(SCRIPT_OVERRUNS_KEY, rule->scriptOverrunCount());
+        }
+        metrics.insert(i.key(), ruleMetrics);
+    }
+    return metrics;
+}
+
+void ReplayDriver::slotComponentLoadingFinished(const QUrl &url, bool ok)
+{
+    if (!ok) {
+        qWarning() << "Failed to load" << url << m_engine->componentError(url);
+    }
+
+    m_loading.remove(url);
+    if (m_loading.isEmpty()) {
+        m_engine->start();
+        slotEngineReadyChanged();
+    }
+}
+
+void ReplayDriver::slotEngineReadyChanged()
+{
+    if (m_engine->isReady() && m_loading.isEmpty() && !m_started) {
+        m_started = true;
+        startReplay();
+    }
+}
+
+void ReplayDriver::startReplay()
+{
+    // Triggers only fire from the trace, time triggers
+    // would otherwise fire again from the virtual clock
+    for (const QUrl &source : m_rules) {
+        Rule *rule = m_engine->rule(source);
+        if (rule && rule->trigger()) {
+            rule->trigger()->setPassive(true);
+        }
+    }
+
+    m_elapsedTimer.start();
+    slotReplay();
+}
+
+void ReplayDriver::slotReplay()
+{
+    // Events that are due are fired in batches,
+    // without going through the event loop each time
+    int count = 0;
+    while (m_hasNext && count < BATCH_SIZE) {
+        qint64 due = m_speed > 0. ? qint64((m_next.timestamp - m_firstTimestamp) / m_speed) : 0;
+        if (due > m_elapsedTimer.elapsed()) {
+            break;
+        }
+
+        fire(m_next);
+        ++count;
+        TriggerTraceEvent next;
+        m_hasNext = m_reader.readNext(next);
+        if (m_hasNext) {
+            m_next = next;
+        }
+    }
+
+    if (!m_hasNext) {
+        finish();
+        return;
+    }
+    scheduleNext();
+}
+
+void ReplayDriver::scheduleNext()
+{
+    qint64 due = m_speed > 0. ? qint64((m_next.timestamp - m_firstTimestamp) / m_speed) : 0;
+    m_timer->start(int(qMax<qint64>(0, due - m_elapsedTimer.elapsed())));
+}
+
+void ReplayDriver::finish()
+{
+    if (!m_reader.errorString().isEmpty()) {
+        qWarning() << m_reader.errorString();
+    }
+    m_elapsed = m_elapsedTimer.elapsed();
+    emit finished();
+}
+
+void ReplayDriver::fire(const TriggerTraceEvent &event)
+{
+    QString key = ruleKey(QUrl(event.rule).toLocalFile());
+    Rule *rule = m_rules.contains(key) ? m_engine->rule(m_rules.value(key)) : 0;
+    m_clock->advanceTo(QDateTime::fromMSecsSinceEpoch(event.timestamp));
+    if (!rule || !rule->trigger()) {
+        ++m_unmatched;
+        return;
+    }
+
+    // Conditions and actions run synchronously, unless the rule is debounced
+    QElapsedTimer timer;
+    timer.start();
+    rule->trigger()->fire(event.payload, QDateTime::fromMSecsSinceEpoch(event.timestamp));
+    qint64 time = timer.nsecsElapsed();
+
+    RuleMetrics &metrics = m_metrics[key];
+    ++metrics.events;
+    metrics.totalTime += time;
+    metrics.times.append(time);
+    ++m_replayed;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef REPLAYDRIVER_H
+#define REPLAYDRIVER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+#include <triggertracereader.h>
+
+class QTimer;
+class PhoneBotEngine;
+class MetaTypeCache;
+class VirtualClock;
+
+// Replays a trigger trace against a set of rules
+//
+// The events of the trace are fired on the trigger of the matching
+// rule, with their recorded timestamp and payload. The time between
+// two events is divided by the speed, a speed of 0 replaying the
+// trace as fast as possible. Rules are matched after their directory
+// and file name, so that a trace recorded on a device can be replayed
+// against a copy of its rules.
+//
+// The rules run on a simulated clock, that is advanced to the
+// timestamp of each event before it is fired, so that timers
+// and policies follow the time of the trace.
+class ReplayDriver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReplayDriver(QObject *parent = 0);
+    void setSpeed(double speed);
+    bool load(const QString &trace, const QStringList &rules);
+    qint64 replayedCount() const;
+    qint64 unmatchedCount() const;
+    qint64 elapsed() const; // In msecs, real time spent replaying
+    qint64 simulatedTime() const; // In msecs, time covered by the trace
+    QVariantMap metrics() const;
+    static QString ruleKey(const QString &path);
+Q_SIGNALS:
+    void finished();
+private Q_SLOTS:
+    void slotComponentLoadingFinished(const QUrl &url, bool ok);
+    void slotEngineReadyChanged();
+    void slotReplay();
+private:
+    struct RuleMetrics
+    {
+        RuleMetrics() : events(0), totalTime(0) {}
+        qint64 events;
+        qint64 totalTime; // In nsecs
+        QVector<qint64> times;
+    };
+    void startReplay();
+    void scheduleNext();
+    void finish();
+    void fire(const TriggerTraceEvent &event);
+    double m_speed;
+    VirtualClock *m_clock;
+    PhoneBotEngine *m_engine;
+    MetaTypeCache *m_typeCache;
+    TriggerTraceReader m_reader;
+    QHash<QString, QUrl> m_rules;
+    QSet<QUrl> m_loading;
+    QHash<QString, RuleMetrics> m_metrics;
+    QTimer *m_timer;
+    QElapsedTimer m_elapsedTimer;
+    TriggerTraceEvent m_next;
+    bool m_hasNext;
+    bool m_started;
+    qint64 m_firstTimestamp;
+    qint64 m_replayed;
+    qint64 m_unmatched;
+    qint64 m_elapsed;
+};
+
+#endif // REPLAYDRIVER_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QTextStream>
+#include <QtCore/QtPlugin>
+#include <phonebotengine.h>
+#include "rulegenerator.h"
+
+Q_IMPORT_PLUGIN(PhoneBotDebugPlugin)
+Q_IMPORT_PLUGIN(PhoneBotProfilePlugin)
+Q_IMPORT_PLUGIN(PhoneBotTimePlugin)
+Q_IMPORT_PLUGIN(PhoneBotConnmanPlugin)
+Q_IMPORT_PLUGIN(PhoneBotAmbiencePlugin)
+Q_IMPORT_PLUGIN(PhoneBotNotificationsPlugin)
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a synthetic set of rules, laid out like the "
+                                     "configuration folder of phonebotd.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "Folder where rule_<n>/rule.qml are written.");
+    QCommandLineOption countOption ("count", "Number of rules to generate.", "count", "100");
+    QCommandLineOption seedOption ("seed", "Seed used to pick components and values.", "seed");
+    QCommandLineOption triggersOption ("triggers", "Trigger mix, as type=weight,...", "mix");
+    QCommandLineOption conditionsOption ("conditions", "Condition mix, as type=weight,... "
+                                         "Use none for rules without condition.", "mix");
+    QCommandLineOption actionsOption ("actions", "Action mix, as type=weight,...", "mix");
+    QCommandLineOption actionCountOption ("actions-per-rule", "Number of actions per rule, "
+                                          "as count or min-max.", "range", "1");
+    parser.addOption(countOption);
+    parser.addOption(seedOption);
+    parser.addOption(triggersOption);
+    parser.addOption(conditionsOption);
+    parser.addOption(actionsOption);
+    parser.addOption(actionCountOption);
+    parser.process(app);
+
+    QStringList arguments = parser.positionalArguments();
+    if (arguments.count() != 1) {
+        parser.showHelp(1);
+    }
+
+    bool ok = false;
+    int count = parser.value(countOption).toInt(&ok);
+    if (!ok || count < 0) {
+        QTextStream(stderr) << "Invalid rule count " << parser.value(countOption) << endl;
+        return 1;
+    }
+
+    uint seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt()
+                                         : uint(QDateTime::currentMSecsSinceEpoch());
+    qsrand(seed);
+
+    PhoneBotEngine::registerTypes();
+    RuleGenerator generator;
+    ok = generator.setActionCount(parser.value(actionCountOption));
+    if (ok && parser.isSet(triggersOption)) {
+        ok = generator.setTriggerMix(parser.value(triggersOption));
+    }
+    if (ok && parser.isSet(conditionsOption)) {
+        ok = generator.setConditionMix(parser.value(conditionsOption));
+    }
+    if (ok && parser.isSet(actionsOption)) {
+        ok = generator.setActionMix(parser.value(actionsOption));
+    }
+    if (ok) {
+        ok = generator.generate(arguments.first(), count);
+    }
+    if (!ok) {
+        QTextStream(stderr) << generator.errorString() << endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << count << " rules written to " << arguments.first()
+                        << " with seed " << seed << endl;
+    return 0;
+}
@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = phonebot-rulegen
+
+QT = core dbus qml
+
+include(../../config.pri)
+include(../libs.pri)
+
+INCLUDEPATH += ../../lib/core \
+    ../../lib/meta \
+    ../../lib/config
+
+HEADERS = \
+    rulegenerator.h
+
+SOURCES = \
+    main.cpp \
+    rulegenerator.cpp
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "rulegenerator.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTime>
+#include <choicemodel.h>
+#include <metaproperty.h>
+#include <metatypecache.h>
+#include <phonebothelper.h>
+#include <rulecomponentmodel.h>
+#include <ruledefinition.h>
+
+static const char *NONE = "none";
+static const char *RULE_FILE = "rule.qml";
+static const char *DIR_FORMAT = "rule_%1";
+static const int DIR_DIGITS = 5;
+static const int MAX_INT_VALUE = 100;
+static const int MAX_DOUBLE_VALUE = 10000; // In hundredths
+
+RuleGenerator::RuleGenerator()
+    : m_typeCache(MetaTypeCache::instance()), m_minActions(1), m_maxActions(1)
+{
+    m_triggers = defaultMix(m_typeCache->components(MetaTypeCache::Trigger));
+    m_conditions = defaultMix(m_typeCache->components(MetaTypeCache::Condition) << NONE);
+    m_actions = defaultMix(m_typeCache->components(MetaTypeCache::Action));
+}
+
+bool RuleGenerator::setTriggerMix(const QString &mix)
+{
+    return parseMix(mix, m_typeCache->components(MetaTypeCache::Trigger), false, m_triggers);
+}
+
+bool RuleGenerator::setConditionMix(const QString &mix)
+{
+    return parseMix(mix, m_typeCache->components(MetaTypeCache::Condition), true, m_conditions);
+}
+
+bool RuleGenerator::setActionMix(const QString &mix)
+{
+    return parseMix(mix, m_typeCache->components(MetaTypeCache::Action), false, m_actions);
+}
+
+bool RuleGenerator::setActionCount(const QString &range)
+{
+    QStringList bounds = range.split('-');
+    bool minOk = false;
+    bool maxOk = false;
+    int min = bounds.first().toInt(&minOk);
+    int max = bounds.count() == 2 ? bounds.last().toInt(&maxOk) : min;
+    if (bounds.count() == 1) {
+        maxOk = minOk;
+    }
+    if (!minOk || !maxOk || bounds.count() > 2 || min < 1 || max < min) {
+        m_errorString = QString("Invalid action count %1").arg(range);
+        return false;
+    }
+    m_minActions = min;
+    m_maxActions = max;
+    return true;
+}
+
+bool RuleGenerator::generate(const QString &path, int count)
+{
+    QDir dir (path);
+    if (!dir.mkpath(".")) {
+        m_errorString = QString("Failed to create %1").arg(path);
+        return false;
+    }
+
+    for (int i = 1; i <= count; ++i) {
+        RuleDefinition definition;
+        if (!createRule(definition, i)) {
+            return false;
+        }
+
+        QString dirName = ruleDirName(i);
+        if (!dir.mkpath(dirName)) {
+            m_errorString = QString("Failed to create %1").arg(dir.absoluteFilePath(dirName));
+            return false;
+        }
+
+        QFile file (QDir(dir.absoluteFilePath(dirName)).absoluteFilePath(RULE_FILE));
+        if (!file.open(QIODevice::WriteOnly)) {
+            m_errorString = QString("Failed to write %1").arg(file.fileName());
+            return false;
+        }
+        file.write(definition.toDocument()->toString().toLocal8Bit());
+        file.close();
+    }
+    return true;
+}
+
+QString RuleGenerator::errorString() const
+{
+    return m_errorString;
+}
+
+// Same naming as the rules added by the daemon
+QString RuleGenerator::ruleDirName(int index)
+{
+    return QString(DIR_FORMAT).arg(index, DIR_DIGITS, 10, QChar('0'));
+}
+
+bool RuleGenerator::parseMix(const QString &mix, const QStringList &available, bool allowNone,
+                             Mix &result)
+{
+    Mix parsed;
+    for (const QString &entry : mix.split(',', QString::SkipEmptyParts)) {
+        QStringList parts = entry.split('=');
+        QString type = parts.first().trimmed();
+        int weight = 1;
+        bool ok = true;
+        if (parts.count() == 2) {
+            weight = parts.last().toInt(&ok);
+        }
+        if (!ok || parts.count() > 2 || weight < 0) {
+            m_errorString = QString("Invalid weight in %1").arg(entry);
+            return false;
+        }
+        if (!available.contains(type) && !(allowNone && type == NONE)) {
+            m_errorString = QString("Unknown component %1, available components are %2")
+                            .arg(type, available.join(", "));
+            return false;
+        }
+        if (weight > 0) {
+            parsed.append(qMakePair(type, weight));
+        }
+    }
+
+    if (parsed.isEmpty()) {
+        m_errorString = QString("No component in %1").arg(mix);
+        return false;
+    }
+    result = parsed;
+    return true;
+}
+
+RuleGenerator::Mix RuleGenerator::defaultMix(const QStringList &available)
+{
+    Mix mix;
+    for (const QString &type : available) {
+        mix.append(qMakePair(type, 1));
+    }
+    return mix;
+}
+
+QString RuleGenerator::pick(const Mix &mix)
+{
+    int total = 0;
+    for (const QPair<QString, int> &entry : mix) {
+        total += entry.second;
+    }
+    if (total == 0) {
+        return QString();
+    }
+
+    int value = qrand() % total;
+    for (const QPair<QString, int> &entry : mix) {
+        if (value < entry.second) {
+            return entry.first;
+        }
+        value -= entry.second;
+    }
+    return QString();
+}
+
+void RuleGenerator::fillComponent(RuleComponentModel *component, int index)
+{
+    for (int i = 0; i < component->count(); ++i) {
+        QModelIndex modelIndex = component->index(i);
+        MetaProperty *property = component->data(modelIndex, RuleComponentModel::Type).value<MetaProperty *>();
+        if (!property) {
+            continue;
+        }
+
+        ChoiceModel *choices = property->choiceModel();
+        if (property->subType() == MetaProperty::ChoiceSubType && choices && choices->count() > 0) {
+            QModelIndex choice = choices->index(qrand() % choices->count());
+            component->setValue(i, choices->data(choice, ChoiceModel::Value));
+            continue;
+        }
+
+        switch (property->type()) {
+        case MetaProperty::String:
+            component->setValue(i, QString("%1 %2").arg(property->name()).arg(index));
+            break;
+        case MetaProperty::Int:
+            component->setValue(i, qrand() % MAX_INT_VALUE);
+            break;
+        case MetaProperty::Double:
+            component->setValue(i, (qrand() % MAX_DOUBLE_VALUE) / 100.);
+            break;
+        case MetaProperty::Bool:
+            component->setValue(i, qrand() % 2 == 0);
+            break;
+        case MetaProperty::Time:
+            component->setValue(i, QTime(qrand() % 24, qrand() % 60));
+            break;
+        }
+    }
+}
+
+bool RuleGenerator::createRule(RuleDefinition &definition, int index)
+{
+    definition.setName(QString("Generated rule %1").arg(index));
+
+    QString triggerType = pick(m_triggers);
+    RuleComponentModel *trigger = definition.createTempComponent(PhoneBotHelper::Trigger, -1,
+                                                                 triggerType);
+    if (!trigger) {
+        m_errorString = QString("Failed to create trigger %1").arg(triggerType);
+        return false;
+    }
+    fillComponent(trigger, index);
+
+    QString conditionType = pick(m_conditions);
+    if (conditionType != NONE) {
+        RuleComponentModel *condition = definition.createTempComponent(PhoneBotHelper::Condition, -1,
+                                                                       conditionType);
+        if (!condition) {
+            m_errorString = QString("Failed to create condition %1").arg(conditionType);
+            return false;
+        }
+        fillComponent(condition, index);
+    }
+    definition.saveComponent(-1);
+
+    RuleDefinitionActionModel *actions = definition.actions();
+    int actionCount = m_minActions + qrand() % (m_maxActions - m_minActions + 1);
+    for (int i = 0; i < actionCount; ++i) {
+        QString actionType = pick(m_actions);
+        RuleComponentModel *action = actions->createTempComponent(PhoneBotHelper::Action,
+                                                                  actions->count(), actionType);
+        if (!action) {
+            m_errorString = QString("Failed to create action %1").arg(actionType);
+            return false;
+        }
+        fillComponent(action, index);
+        actions->saveComponent(actions->count());
+    }
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef RULEGENERATOR_H
+#define RULEGENERATOR_H
+
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class MetaTypeCache;
+class RuleComponentModel;
+class RuleDefinition;
+
+// Generates synthetic rule sets
+//
+// Rules are built with RuleDefinition, like the ones created
+// in the UI, and written as rule_<n>/rule.qml, so that the output
+// folder can be used as the configuration folder of the daemon.
+//
+// Each mix is a list of component types with a weight, like
+// "TimeTrigger=3,DebugTrigger=1". The condition mix can contain
+// "none", for rules without condition. By default, every
+// available component has the same weight.
+class RuleGenerator
+{
+public:
+    explicit RuleGenerator();
+    bool setTriggerMix(const QString &mix);
+    bool setConditionMix(const QString &mix);
+    bool setActionMix(const QString &mix);
+    bool setActionCount(const QString &range);
+    bool generate(const QString &path, int count);
+    QString errorString() const;
+    static QString ruleDirName(int index);
+private:
+    typedef QList<QPair<QString, int> > Mix;
+    bool parseMix(const QString &mix, const QStringList &available, bool allowNone, Mix &result);
+    static Mix defaultMix(const QStringList &available);
+    static QString pick(const Mix &mix);
+    static void fillComponent(RuleComponentModel *component, int index);
+    bool createRule(RuleDefinition &definition, int index);
+    MetaTypeCache *m_typeCache;
+    Mix m_triggers;
+    Mix m_conditions;
+    Mix m_actions;
+    int m_minActions;
+    int m_maxActions;
+    QString m_errorString;
+};
+
+#endif // RULEGENERATOR_H
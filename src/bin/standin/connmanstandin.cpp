@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "connmanstandin.h"
+#include <QtDBus/QDBusConnection>
+
+static const char *SERVICE = "net.connman";
+static const char *MANAGER_PATH = "/";
+static const char *WIFI_PATH = "/net/connman/technology/wifi";
+static const char *CELLULAR_PATH = "/net/connman/service/cellular_standin_context1";
+static const char *STATE_KEY = "State";
+static const char *CONNECTED_KEY = "Connected";
+static const char *READY_STATE = "ready";
+static const char *IDLE_STATE = "idle";
+
+ConnmanPropertiesStandin::ConnmanPropertiesStandin(const QString &path,
+                                                   const QVariantMap &properties,
+                                                   FaultInjector *injector, QObject *parent)
+    : StandinObject(injector, parent), m_path(path), m_properties(properties)
+{
+}
+
+ConnmanObject ConnmanPropertiesStandin::object() const
+{
+    ConnmanObject object;
+    object.path = QDBusObjectPath(m_path);
+    object.properties = m_properties;
+    return object;
+}
+
+QVariantMap ConnmanPropertiesStandin::GetProperties()
+{
+    reply(QVariantList() << m_properties);
+    return m_properties;
+}
+
+void ConnmanPropertiesStandin::SetProperty(const QString &name, const QDBusVariant &value)
+{
+    if (!reply()) {
+        return;
+    }
+
+    if (m_properties.value(name) != value.variant()) {
+        m_properties.insert(name, value.variant());
+        emit PropertyChanged(name, value);
+    }
+}
+
+void ConnmanPropertiesStandin::ClearProperty(const QString &name)
+{
+    if (!reply()) {
+        return;
+    }
+    m_properties.remove(name);
+}
+
+ConnmanTechnologyStandin::ConnmanTechnologyStandin(const QString &path,
+                                                   const QVariantMap &properties,
+                                                   FaultInjector *injector, QObject *parent)
+    : ConnmanPropertiesStandin(path, properties, injector, parent)
+{
+}
+
+void ConnmanTechnologyStandin::Scan()
+{
+    reply();
+}
+
+ConnmanServiceStandin::ConnmanServiceStandin(const QString &path, const QVariantMap &properties,
+                                             FaultInjector *injector, QObject *parent)
+    : ConnmanPropertiesStandin(path, properties, injector, parent)
+{
+}
+
+void ConnmanServiceStandin::Connect()
+{
+    if (!reply()) {
+        return;
+    }
+    emit PropertyChanged(STATE_KEY, QDBusVariant(QString(READY_STATE)));
+}
+
+void ConnmanServiceStandin::Disconnect()
+{
+    if (!reply()) {
+        return;
+    }
+    emit PropertyChanged(STATE_KEY, QDBusVariant(QString(IDLE_STATE)));
+}
+
+ConnmanStandin::ConnmanStandin(FaultInjector *injector, QObject *parent)
+    : StandinObject(injector, parent)
+{
+    m_properties.insert(STATE_KEY, QString("online"));
+    m_properties.insert("OfflineMode", false);
+    m_properties.insert("SessionMode", false);
+
+    QVariantMap wifi;
+    wifi.insert("Name", QString("WiFi"));
+    wifi.insert("Type", QString("wifi"));
+    wifi.insert("Powered", true);
+    wifi.insert(CONNECTED_KEY, false);
+    wifi.insert("Tethering", false);
+    m_technologies.append(new ConnmanTechnologyStandin(WIFI_PATH, wifi, injector, this));
+
+    QVariantMap cellular;
+    cellular.insert("Name", QString("Cellular"));
+    cellular.insert("Type", QString("cellular"));
+    cellular.insert(STATE_KEY, QString(READY_STATE));
+    cellular.insert("Favorite", true);
+    cellular.insert("AutoConnect", true);
+    cellular.insert("Strength", 80);
+    m_services.append(new ConnmanServiceStandin(CELLULAR_PATH, cellular, injector, this));
+}
+
+bool ConnmanStandin::registerOn(QDBusConnection connection)
+{
+    QDBusConnection::RegisterOptions options = QDBusConnection::ExportAllSlots
+                                               | QDBusConnection::ExportAllSignals;
+    if (!connection.registerService(SERVICE)
+        || !connection.registerObject(MANAGER_PATH, this, options)) {
+        return false;
+    }
+
+    foreach (ConnmanTechnologyStandin *technology, m_technologies) {
+        if (!connection.registerObject(technology->object().path.path(), technology, options)) {
+            return false;
+        }
+    }
+    foreach (ConnmanServiceStandin *service, m_services) {
+        if (!connection.registerObject(service->object().path.path(), service, options)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QVariantMap ConnmanStandin::GetProperties()
+{
+    reply(QVariantList() << m_properties);
+    return m_properties;
+}
+
+void ConnmanStandin::SetProperty(const QString &name, const QDBusVariant &value)
+{
+    if (!reply()) {
+        return;
+    }
+
+    if (m_properties.value(name) != value.variant()) {
+        m_properties.insert(name, value.variant());
+        emit PropertyChanged(name, value);
+    }
+}
+
+ConnmanObjectList ConnmanStandin::GetTechnologies()
+{
+    ConnmanObjectList technologies;
+    foreach (ConnmanTechnologyStandin *technology, m_technologies) {
+        technologies.append(technology->object());
+    }
+    reply(QVariantList() << QVariant::fromValue(technologies));
+    return technologies;
+}
+
+ConnmanObjectList ConnmanStandin::GetServices()
+{
+    ConnmanObjectList services;
+    foreach (ConnmanServiceStandin *service, m_services) {
+        services.append(service->object());
+    }
+    reply(QVariantList() << QVariant::fromValue(services));
+    return services;
+}
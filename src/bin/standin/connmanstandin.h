@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef CONNMANSTANDIN_H
+#define CONNMANSTANDIN_H
+
+#include <QtCore/QList>
+#include <QtDBus/QDBusVariant>
+#include "standinobject.h"
+#include "standintypes.h"
+
+// Stand-in for connman, used by the connman plugin through libconnman-qt
+//
+// It exposes a powered wifi technology and a single favorite
+// cellular service, which is what WlanSwitchAction and
+// DataSwitchAction look for.
+class ConnmanPropertiesStandin : public StandinObject
+{
+    Q_OBJECT
+public:
+    explicit ConnmanPropertiesStandin(const QString &path, const QVariantMap &properties,
+                                      FaultInjector *injector, QObject *parent = 0);
+    ConnmanObject object() const;
+public Q_SLOTS:
+    QVariantMap GetProperties();
+    void SetProperty(const QString &name, const QDBusVariant &value);
+    void ClearProperty(const QString &name);
+Q_SIGNALS:
+    void PropertyChanged(const QString &name, const QDBusVariant &value);
+private:
+    QString m_path;
+    QVariantMap m_properties;
+};
+
+class ConnmanTechnologyStandin : public ConnmanPropertiesStandin
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.connman.Technology")
+public:
+    explicit ConnmanTechnologyStandin(const QString &path, const QVariantMap &properties,
+                                      FaultInjector *injector, QObject *parent = 0);
+public Q_SLOTS:
+    void Scan();
+};
+
+class ConnmanServiceStandin : public ConnmanPropertiesStandin
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.connman.Service")
+public:
+    explicit ConnmanServiceStandin(const QString &path, const QVariantMap &properties,
+                                   FaultInjector *injector, QObject *parent = 0);
+public Q_SLOTS:
+    void Connect();
+    void Disconnect();
+};
+
+class ConnmanStandin : public StandinObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.connman.Manager")
+public:
+    explicit ConnmanStandin(FaultInjector *injector, QObject *parent = 0);
+    bool registerOn(QDBusConnection connection);
+public Q_SLOTS:
+    QVariantMap GetProperties();
+    void SetProperty(const QString &name, const QDBusVariant &value);
+    ConnmanObjectList GetTechnologies();
+    ConnmanObjectList GetServices();
+Q_SIGNALS:
+    void PropertyChanged(const QString &name, const QDBusVariant &value);
+    void TechnologyAdded(const QDBusObjectPath &path, const QVariantMap &properties);
+    void TechnologyRemoved(const QDBusObjectPath &path);
+    void ServicesChanged(const ConnmanObjectList &changed, const QList<QDBusObjectPath> &removed);
+private:
+    QVariantMap m_properties;
+    QList<ConnmanTechnologyStandin *> m_technologies;
+    QList<ConnmanServiceStandin *> m_services;
+};
+
+#endif // CONNMANSTANDIN_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "faultinjector.h"
+#include <QtCore/QtGlobal>
+
+static const char *CALLS_KEY = "calls";
+static const char *FAILURES_KEY = "failures";
+static const char *MEAN_DELAY_KEY = "meanDelay";
+static const char *MAX_DELAY_KEY = "maxDelay";
+static const char *LATENCY_KEY = "latency";
+static const char *JITTER_KEY = "jitter";
+static const char *FAILURE_RATE_KEY = "failureRate";
+
+FaultInjector::FaultInjector(const QString &backend, QObject *parent)
+    : QObject(parent), m_backend(backend), m_latency(0), m_jitter(0), m_failureRate(0.)
+    , m_calls(0), m_failures(0), m_totalDelay(0), m_maxDelay(0)
+{
+}
+
+QString FaultInjector::backend() const
+{
+    return m_backend;
+}
+
+int FaultInjector::latency() const
+{
+    return m_latency;
+}
+
+int FaultInjector::jitter() const
+{
+    return m_jitter;
+}
+
+double FaultInjector::failureRate() const
+{
+    return m_failureRate;
+}
+
+void FaultInjector::configure(int latency, int jitter, double failureRate)
+{
+    m_latency = qMax(0, latency);
+    m_jitter = qMax(0, jitter);
+    m_failureRate = qBound(0., failureRate, 1.);
+}
+
+int FaultInjector::nextDelay()
+{
+    if (m_jitter == 0) {
+        return m_latency;
+    }
+    return m_latency + qrand() % (m_jitter + 1);
+}
+
+bool FaultInjector::nextFailure()
+{
+    if (m_failureRate <= 0.) {
+        return false;
+    }
+    return qrand() < m_failureRate * RAND_MAX;
+}
+
+void FaultInjector::record(int delay, bool failed)
+{
+    ++m_calls;
+    if (failed) {
+        ++m_failures;
+    }
+    m_totalDelay += delay;
+    m_maxDelay = qMax(m_maxDelay, delay);
+}
+
+QVariantMap FaultInjector::statistics() const
+{
+    QVariantMap statistics;
+    statistics.insert(LATENCY_KEY, m_latency);
+    statistics.insert(JITTER_KEY, m_jitter);
+    statistics.insert(FAILURE_RATE_KEY, m_failureRate);
+    statistics.insert(CALLS_KEY, m_calls);
+    statistics.insert(FAILURES_KEY, m_failures);
+    statistics.insert(MEAN_DELAY_KEY, m_calls > 0 ? double(m_totalDelay) / m_calls : 0.);
+    statistics.insert(MAX_DELAY_KEY, m_maxDelay);
+    return statistics;
+}
+
+void FaultInjector::resetStatistics()
+{
+    m_calls = 0;
+    m_failures = 0;
+    m_totalDelay = 0;
+    m_maxDelay = 0;
+}
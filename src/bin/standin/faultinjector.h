@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef FAULTINJECTOR_H
+#define FAULTINJECTOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+// Latency and failure settings shared by all the objects
+// of a stand-in backend, with the statistics of the calls
+class FaultInjector : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FaultInjector(const QString &backend, QObject *parent = 0);
+    QString backend() const;
+    int latency() const;
+    int jitter() const;
+    double failureRate() const;
+    void configure(int latency, int jitter, double failureRate);
+    // Picks the delay of the next reply, and if it should fail
+    int nextDelay();
+    bool nextFailure();
+    void record(int delay, bool failed);
+    QVariantMap statistics() const;
+    void resetStatistics();
+private:
+    QString m_backend;
+    int m_latency;
+    int m_jitter;
+    double m_failureRate;
+    qint64 m_calls;
+    qint64 m_failures;
+    qint64 m_totalDelay;
+    int m_maxDelay;
+};
+
+#endif // FAULTINJECTOR_H
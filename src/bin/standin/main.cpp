@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+#include <QtDBus/QDBusConnection>
+#include "ambiencestandin.h"
+#include "connmanstandin.h"
+#include "faultinjector.h"
+#include "notificationsstandin.h"
+#include "profilestandin.h"
+#include "standincontrol.h"
+#include "standintypes.h"
+
+static const char *AMBIENCE_BACKEND = "ambience";
+static const char *CONNMAN_BACKEND = "connman";
+static const char *NOTIFICATIONS_BACKEND = "notifications";
+static const char *PROFILE_BACKEND = "profile";
+
+template<class T>
+static bool startBackend(const QString &backend, const QStringList &backends,
+                         StandinControl *control, int latency, int jitter, double failureRate)
+{
+    if (!backends.contains(backend)) {
+        return true;
+    }
+
+    FaultInjector *injector = new FaultInjector(backend, control);
+    injector->configure(latency, jitter, failureRate);
+    control->addInjector(injector);
+
+    T *standin = new T(injector, control);
+    if (!standin->registerOn(QDBusConnection::sessionBus())) {
+        qWarning() << "Failed to register the" << backend << "stand-in."
+                   << "Maybe the real service is running on this bus";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+    registerStandinTypes();
+
+    QStringList allBackends;
+    allBackends << AMBIENCE_BACKEND << CONNMAN_BACKEND << NOTIFICATIONS_BACKEND << PROFILE_BACKEND;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Stand-in system services for benchmarking the phonebot "
+                                     "plugins. Services are registered on the session bus, "
+                                     "that should be a private bus, see tools/run-standin.sh.");
+    parser.addHelpOption();
+    QCommandLineOption backendsOption ("backends", QString("Comma separated backends to start, "
+                                                           "among %1.").arg(allBackends.join(", ")),
+                                       "backends", allBackends.join(","));
+    QCommandLineOption latencyOption ("latency", "Latency added to every reply, in ms.", "ms", "0");
+    QCommandLineOption jitterOption ("jitter", "Random latency added on top of the latency, in ms.",
+                                     "ms", "0");
+    QCommandLineOption failureRateOption ("failure-rate", "Ratio of calls that fail, between 0 and 1.",
+                                          "rate", "0");
+    QCommandLineOption seedOption ("seed", "Seed used for jitter and failures.", "seed");
+    parser.addOption(backendsOption);
+    parser.addOption(latencyOption);
+    parser.addOption(jitterOption);
+    parser.addOption(failureRateOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    QStringList backends = parser.value(backendsOption).split(',', QString::SkipEmptyParts);
+    foreach (const QString &backend, backends) {
+        if (!allBackends.contains(backend)) {
+            qWarning() << "Unknown backend" << backend;
+            return 1;
+        }
+    }
+
+    bool ok = false;
+    int latency = parser.value(latencyOption).toInt(&ok);
+    if (!ok || latency < 0) {
+        qWarning() << "Invalid latency" << parser.value(latencyOption);
+        return 1;
+    }
+    int jitter = parser.value(jitterOption).toInt(&ok);
+    if (!ok || jitter < 0) {
+        qWarning() << "Invalid jitter" << parser.value(jitterOption);
+        return 1;
+    }
+    double failureRate = parser.value(failureRateOption).toDouble(&ok);
+    if (!ok || failureRate < 0. || failureRate > 1.) {
+        qWarning() << "Invalid failure rate" << parser.value(failureRateOption);
+        return 1;
+    }
+    uint seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt()
+                                         : uint(QDateTime::currentMSecsSinceEpoch());
+    qsrand(seed);
+
+    StandinControl control;
+    if (!startBackend<AmbienceStandin>(AMBIENCE_BACKEND, backends, &control,
+                                       latency, jitter, failureRate)
+        || !startBackend<ConnmanStandin>(CONNMAN_BACKEND, backends, &control,
+                                         latency, jitter, failureRate)
+        || !startBackend<NotificationsStandin>(NOTIFICATIONS_BACKEND, backends, &control,
+                                               latency, jitter, failureRate)
+        || !startBackend<ProfileStandin>(PROFILE_BACKEND, backends, &control,
+                                         latency, jitter, failureRate)) {
+        return 1;
+    }
+
+    if (!control.registerOn(QDBusConnection::sessionBus())) {
+        qWarning() << "Failed to register the stand-in control interface";
+        return 1;
+    }
+
+    return app.exec();
+}
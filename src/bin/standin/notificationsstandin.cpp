@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "notificationsstandin.h"
+#include <QtDBus/QDBusConnection>
+
+static const char *SERVICE = "org.freedesktop.Notifications";
+static const char *PATH = "/org/freedesktop/Notifications";
+static const char *SERVER_NAME = "phonebot-standin";
+static const char *SERVER_VENDOR = "phonebot";
+static const char *SERVER_VERSION = "1.0";
+static const char *SPEC_VERSION = "1.2";
+static const uint CLOSED_BY_CALL = 3;
+
+NotificationsStandin::NotificationsStandin(FaultInjector *injector, QObject *parent)
+    : StandinObject(injector, parent), m_lastId(0)
+{
+}
+
+bool NotificationsStandin::registerOn(QDBusConnection connection)
+{
+    return connection.registerService(SERVICE)
+           && connection.registerObject(PATH, this, QDBusConnection::ExportAllSlots
+                                                    | QDBusConnection::ExportAllSignals);
+}
+
+uint NotificationsStandin::Notify(const QString &appName, uint replacesId, const QString &appIcon,
+                                  const QString &summary, const QString &body,
+                                  const QStringList &actions, const QVariantMap &hints,
+                                  int expireTimeout)
+{
+    Q_UNUSED(appName);
+    Q_UNUSED(appIcon);
+    Q_UNUSED(body);
+    Q_UNUSED(actions);
+    Q_UNUSED(hints);
+    Q_UNUSED(expireTimeout);
+    uint id = m_notifications.contains(replacesId) ? replacesId : m_lastId + 1;
+    if (!reply(QVariantList() << id)) {
+        return 0;
+    }
+
+    m_lastId = qMax(m_lastId, id);
+    m_notifications.insert(id, summary);
+    return id;
+}
+
+void NotificationsStandin::CloseNotification(uint id)
+{
+    if (!reply()) {
+        return;
+    }
+
+    if (m_notifications.remove(id) > 0) {
+        emit NotificationClosed(id, CLOSED_BY_CALL);
+    }
+}
+
+QStringList NotificationsStandin::GetCapabilities()
+{
+    QStringList capabilities;
+    capabilities << "body" << "actions";
+    reply(QVariantList() << capabilities);
+    return capabilities;
+}
+
+QString NotificationsStandin::GetServerInformation(QString &vendor, QString &version,
+                                                   QString &specVersion)
+{
+    vendor = SERVER_VENDOR;
+    version = SERVER_VERSION;
+    specVersion = SPEC_VERSION;
+    reply(QVariantList() << QString(SERVER_NAME) << vendor << version << specVersion);
+    return SERVER_NAME;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "profilestandin.h"
+#include <QtDBus/QDBusConnection>
+
+static const char *SERVICE = "com.nokia.profiled";
+static const char *PATH = "/com/nokia/profiled";
+static const char *STRING_TYPE = "STRING";
+
+ProfileStandin::ProfileStandin(FaultInjector *injector, QObject *parent)
+    : StandinObject(injector, parent), m_profile("general")
+{
+    // Profiles known by profiled on the device, and the names used by ProfileAction
+    m_profiles << "general" << "silent" << "meeting" << "outdoors" << "ambience";
+}
+
+bool ProfileStandin::registerOn(QDBusConnection connection)
+{
+    return connection.registerService(SERVICE)
+           && connection.registerObject(PATH, this, QDBusConnection::ExportAllSlots
+                                                    | QDBusConnection::ExportAllSignals);
+}
+
+QString ProfileStandin::get_profile()
+{
+    reply(QVariantList() << m_profile);
+    return m_profile;
+}
+
+bool ProfileStandin::set_profile(const QString &profile)
+{
+    bool known = m_profiles.contains(profile);
+    if (!reply(QVariantList() << known) || !known) {
+        return false;
+    }
+
+    if (m_profile != profile) {
+        m_profile = profile;
+        emit profile_changed(true, true, profile, values(profile));
+    }
+    return true;
+}
+
+QStringList ProfileStandin::get_profiles()
+{
+    reply(QVariantList() << m_profiles);
+    return m_profiles;
+}
+
+bool ProfileStandin::has_profile(const QString &profile)
+{
+    bool known = m_profiles.contains(profile);
+    reply(QVariantList() << known);
+    return known;
+}
+
+QStringList ProfileStandin::get_keys()
+{
+    QStringList keys;
+    foreach (const QString &profile, m_values.keys()) {
+        foreach (const QString &key, m_values.value(profile).keys()) {
+            if (!keys.contains(key)) {
+                keys.append(key);
+            }
+        }
+    }
+    reply(QVariantList() << keys);
+    return keys;
+}
+
+QString ProfileStandin::get_value(const QString &profile, const QString &key)
+{
+    QString value = m_values.value(profile).value(key);
+    reply(QVariantList() << value);
+    return value;
+}
+
+bool ProfileStandin::set_value(const QString &profile, const QString &key, const QString &value)
+{
+    bool known = m_profiles.contains(profile);
+    if (!reply(QVariantList() << known) || !known) {
+        return false;
+    }
+
+    if (m_values.value(profile).value(key) != value) {
+        m_values[profile].insert(key, value);
+        emit profile_changed(true, profile == m_profile, profile, values(profile));
+    }
+    return true;
+}
+
+ProfileValueList ProfileStandin::values(const QString &profile) const
+{
+    ProfileValueList values;
+    const QMap<QString, QString> &profileValues = m_values.value(profile);
+    for (QMap<QString, QString>::const_iterator i = profileValues.constBegin();
+         i != profileValues.constEnd(); ++i) {
+        ProfileValue value;
+        value.key = i.key();
+        value.value = i.value();
+        value.type = STRING_TYPE;
+        values.append(value);
+    }
+    return values;
+}
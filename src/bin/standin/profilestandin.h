@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef PROFILESTANDIN_H
+#define PROFILESTANDIN_H
+
+#include <QtCore/QStringList>
+#include "standinobject.h"
+#include "standintypes.h"
+
+// Stand-in for profiled, used by ProfileAction through libprofile-qt
+class ProfileStandin : public StandinObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.profiled")
+public:
+    explicit ProfileStandin(FaultInjector *injector, QObject *parent = 0);
+    bool registerOn(QDBusConnection connection);
+public Q_SLOTS:
+    QString get_profile();
+    bool set_profile(const QString &profile);
+    QStringList get_profiles();
+    bool has_profile(const QString &profile);
+    QStringList get_keys();
+    QString get_value(const QString &profile, const QString &key);
+    bool set_value(const QString &profile, const QString &key, const QString &value);
+Q_SIGNALS:
+    void profile_changed(bool changed, bool active, const QString &profile,
+                         const ProfileValueList &values);
+private:
+    ProfileValueList values(const QString &profile) const;
+    QString m_profile;
+    QStringList m_profiles;
+    QMap<QString, QMap<QString, QString> > m_values;
+};
+
+#endif // PROFILESTANDIN_H
@@ -0,0 +1,29 @@
+# Stand-in system services, to run the plugins against
+# on a build machine. See tools/run-standin.sh
+TEMPLATE = app
+TARGET = phonebot-standin
+
+QT = core dbus
+
+include(../../config.pri)
+
+HEADERS = \
+    standintypes.h \
+    faultinjector.h \
+    standinobject.h \
+    standincontrol.h \
+    ambiencestandin.h \
+    connmanstandin.h \
+    notificationsstandin.h \
+    profilestandin.h
+
+SOURCES = \
+    main.cpp \
+    standintypes.cpp \
+    faultinjector.cpp \
+    standinobject.cpp \
+    standincontrol.cpp \
+    ambiencestandin.cpp \
+    connmanstandin.cpp \
+    notificationsstandin.cpp \
+    profilestandin.cpp
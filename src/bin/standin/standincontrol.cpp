@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "standincontrol.h"
+#include <QtDBus/QDBusConnection>
+#include "faultinjector.h"
+
+static const char *SERVICE = "org.SfietKonstantin.phonebot.standin";
+static const char *PATH = "/";
+
+StandinControl::StandinControl(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void StandinControl::addInjector(FaultInjector *injector)
+{
+    m_injectors.insert(injector->backend(), injector);
+}
+
+bool StandinControl::registerOn(QDBusConnection connection)
+{
+    return connection.registerService(SERVICE)
+           && connection.registerObject(PATH, this, QDBusConnection::ExportAllSlots);
+}
+
+QStringList StandinControl::Backends() const
+{
+    return m_injectors.keys();
+}
+
+bool StandinControl::Configure(const QString &backend, int latency, int jitter, double failureRate)
+{
+    // An empty backend configures all of them
+    if (backend.isEmpty()) {
+        foreach (FaultInjector *injector, m_injectors) {
+            injector->configure(latency, jitter, failureRate);
+        }
+        return true;
+    }
+
+    FaultInjector *injector = m_injectors.value(backend);
+    if (!injector) {
+        return false;
+    }
+    injector->configure(latency, jitter, failureRate);
+    return true;
+}
+
+QVariantMap StandinControl::Statistics() const
+{
+    QVariantMap statistics;
+    foreach (FaultInjector *injector, m_injectors) {
+        statistics.insert(injector->backend(), injector->statistics());
+    }
+    return statistics;
+}
+
+void StandinControl::ResetStatistics()
+{
+    foreach (FaultInjector *injector, m_injectors) {
+        injector->resetStatistics();
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef STANDINOBJECT_H
+#define STANDINOBJECT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVariantList>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusContext>
+
+class FaultInjector;
+
+// Base class of the objects exported by the stand-in backends
+//
+// Slots exported on DBus call reply() before doing anything. If
+// latency is injected, the reply is delayed and the return value of
+// the slot is discarded. If a failure is injected, reply() returns
+// false, an error is sent back, and the slot should not change state.
+class StandinObject : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+public:
+    explicit StandinObject(FaultInjector *injector, QObject *parent = 0);
+protected:
+    bool reply(const QVariantList &arguments = QVariantList());
+private:
+    FaultInjector *m_injector;
+};
+
+#endif // STANDINOBJECT_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef STANDINTYPES_H
+#define STANDINTYPES_H
+
+#include <QtCore/QList>
+#include <QtCore/QMetaType>
+#include <QtCore/QVariantMap>
+#include <QtDBus/QDBusArgument>
+#include <QtDBus/QDBusObjectPath>
+
+// a(sss) as sent by profiled in profile_changed
+struct ProfileValue
+{
+    QString key;
+    QString value;
+    QString type;
+};
+typedef QList<ProfileValue> ProfileValueList;
+
+// a(oa{sv}) as used by connman to list technologies and services
+struct ConnmanObject
+{
+    QDBusObjectPath path;
+    QVariantMap properties;
+};
+typedef QList<ConnmanObject> ConnmanObjectList;
+
+QDBusArgument & operator<<(QDBusArgument &argument, const ProfileValue &value);
+const QDBusArgument & operator>>(const QDBusArgument &argument, ProfileValue &value);
+QDBusArgument & operator<<(QDBusArgument &argument, const ConnmanObject &object);
+const QDBusArgument & operator>>(const QDBusArgument &argument, ConnmanObject &object);
+
+void registerStandinTypes();
+
+Q_DECLARE_METATYPE(ProfileValue)
+Q_DECLARE_METATYPE(ProfileValueList)
+Q_DECLARE_METATYPE(ConnmanObject)
+Q_DECLARE_METATYPE(ConnmanObjectList)
+
+#endif // STANDINTYPES_H
@@ -1,4 +1,5 @@
 CONFIG += c++11
+include(logging.pri)
 CONFIG(coverage) {
     QMAKE_CXXFLAGS += -fprofile-arcs -ftest-coverage
     QMAKE_LFLAGS_DEBUG += -lgcov -coverage
@@ -31,11 +31,8 @@
 
 #include "rulecomponentmodel.h"
 #include "rulecomponentmodel_p.h"
-#include <QtCore/QGlobalStatic>
 #include <metatypecache.h>
 
-Q_GLOBAL_STATIC(MetaTypeCache, cache)
-
 RuleComponentModelData::~RuleComponentModelData()
 {
 }
@@ -170,6 +167,7 @@ QVariant RuleComponentModel::data(const QModelIndex &index, int role) const
 
 RuleComponentModel * RuleComponentModel::create(const QString &type, QObject *parent)
 {
+    MetaTypeCache *cache = MetaTypeCache::instance();
     if (!cache->exists(type)) {
         return 0;
     }
@@ -35,8 +35,6 @@
 #include <metatypecache.h>
 #include <QtCore/QDebug>
 
-Q_GLOBAL_STATIC(MetaTypeCache, cache)
-
 RuleComponentsModelData::~RuleComponentsModelData()
 {
 }
@@ -130,6 +128,7 @@ void RuleComponentsModel::setType(PhoneBotHelper::ComponentType type)
 //            qWarning() << "Components cache not initialized";
 //            return;
 //        }
+        MetaTypeCache *cache = MetaTypeCache::instance();
         QStringList components = cache->components((MetaTypeCache::Type) type);
 
         QList<RuleComponentsModelData *> items;
@@ -31,14 +31,11 @@
 
 #include "ruledefinition.h"
 #include <QtCore/QDebug>
-#include <QtCore/QGlobalStatic>
 #include <QtCore/QSet>
 #include <QtCore/QTime>
 #include <metatypecache.h>
 #include <metaproperty.h>
 
-Q_GLOBAL_STATIC(MetaTypeCache, cache)
-
 class RuleDefinitionPrivate
 {
 public:
@@ -182,8 +179,7 @@ void RuleDefinition::discardComponent(int index)
 }
 
 static QmlObject::Ptr convertComponentModelToObject(RuleComponentModel *componentModel,
-                                                    QSet<ImportStatement::Ptr> &imports,
-                                                    QList<QmlObject::Ptr> &mappers)
+                                                    QSet<ImportStatement::Ptr> &imports)
 {
     if (!componentModel) {
         return QmlObject::Ptr();
@@ -191,7 +187,7 @@ static QmlObject::Ptr convertComponentModelToObject(RuleComponentModel *componen
 
     QString type = componentModel->type();
     QmlObject::Ptr object = QmlObject::create(type);
-    imports.insert(cache->import(type));
+    imports.insert(MetaTypeCache::instance()->import(type));
     QVariantMap properties;
 
     for (int i = 0; i < componentModel->count(); ++i) {
@@ -209,20 +205,11 @@ static QmlObject::Ptr convertComponentModelToObject(RuleComponentModel *componen
                 }
             }
 
+            // Times are written as literals, no mapper is needed
             if (type->type() == MetaProperty::Time) {
-                QmlObject::Ptr timeMapper = QmlObject::create("TimeMapper");
-                QVariantMap timeProperties;
                 QTime valueTime = value.toTime();
                 if (valueTime.isValid()) {
-                    timeProperties.insert("hour", valueTime.hour());
-                    timeProperties.insert("minute", valueTime.minute());
-                    timeMapper->setProperties(timeProperties);
-                    QString id = QString("mapper%1").arg(mappers.count());
-                    timeMapper->setId(id);
-                    mappers.append(timeMapper);
-                    QStringList fieldValues;
-                    fieldValues.append("value");
-                    properties.insert(type->name(), QVariant::fromValue(Reference::create(id, fieldValues)));
+                    properties.insert(type->name(), QVariant(valueTime));
                 }
             } else {
                 // Insert key value
@@ -267,7 +254,6 @@ QmlDocumentBase::Ptr RuleDefinition::toDocument() const
     QmlObject::Ptr root = QmlObject::create("Rule");
     QSet<ImportStatement::Ptr> imports;
     imports.insert(ImportStatement::createImport("org.SfietKonstantin.phonebot", "1.0"));
-    QList<QmlObject::Ptr> mappers;
     QVariantMap properties;
 
     if (!d->name.trimmed().isEmpty()) {
@@ -276,14 +262,14 @@ QmlDocumentBase::Ptr RuleDefinition::toDocument() const
 
     // Trigger
     QmlObject::Ptr trigger = convertComponentModelToObject(d->components.value(PhoneBotHelper::Trigger),
-                                                           imports, mappers);
+                                                           imports);
     if (!trigger.isNull()) {
         properties.insert("trigger", QVariant::fromValue(trigger));
     }
 
     // Condition
     QmlObject::Ptr condition = convertComponentModelToObject(d->components.value(PhoneBotHelper::Condition),
-                                                             imports, mappers);
+                                                             imports);
     if (!condition.isNull()) {
         properties.insert("condition", QVariant::fromValue(condition));
     }
@@ -292,9 +278,14 @@ QmlDocumentBase::Ptr RuleDefinition::toDocument() const
     QVariantList actions;
     for (int i = 0; i < d->actions->count(); ++i) {
         RuleComponentModel *component = d->actions->data(d->actions->index(i), RuleDefinitionActionModel::Component).value<RuleComponentModel *>();
-        QmlObject::Ptr action = convertComponentModelToObject(component, imports, mappers);
+        QmlObject::Ptr action = convertComponentModelToObject(component, imports);
         if (!action.isNull()) {
-            actions.append(QVariant::fromValue(action));
+            // Actions are only created when the rule is triggered
+            QmlObject::Ptr lazyAction = QmlObject::create("LazyAction");
+            QVariantMap lazyProperties;
+            lazyProperties.insert("component", QVariant::fromValue(action));
+            lazyAction->setProperties(lazyProperties);
+            actions.append(QVariant::fromValue(lazyAction));
         }
     }
 
@@ -302,16 +293,6 @@ QmlDocumentBase::Ptr RuleDefinition::toDocument() const
         properties.insert("actions", actions);
     }
 
-    // Mappers
-    QVariantList mappersVariant;
-    for (QmlObject::Ptr mapper : mappers) {
-        mappersVariant.append(QVariant::fromValue(mapper));
-    }
-
-    if (!mappersVariant.isEmpty()) {
-        properties.insert("mappers", mappersVariant);
-    }
-
     root->setProperties(properties);
     for (ImportStatement::Ptr import : imports) {
         doc->addImport(import);
@@ -32,12 +32,14 @@
 #include "rulesmodel.h"
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
+#include <QtCore/QTime>
 #include <qmldocument.h>
 #include <metaproperty.h>
 #include "ruledefinition.h"
 
 static const char *SERVICE = "org.SfietKonstantin.phonebot";
 static const char *PATH = "/";
+static const char *TIME_FORMAT = "hh:mm";
 
 struct RulesModelData
 {
@@ -143,6 +145,8 @@ static void populateRuleComponentModel(RuleComponentModel *component, QmlObject:
                             component->setValue(i, QVariant(time));
                         }
                     }
+                } else if (meta->type() == MetaProperty::Time) {
+                    component->setValue(i, QVariant(QTime::fromString(value.toString(), TIME_FORMAT)));
                 } else {
                     component->setValue(i, value);
                 }
@@ -155,6 +159,10 @@ void RulesModel::reload()
 {
     if (!m_data.isEmpty()) {
         beginRemoveRows(QModelIndex(), 0, rowCount() - 1);
+        // Definitions might still be referenced from QML
+        for (RulesModelData *data : m_data) {
+            data->definition->deleteLater();
+        }
         qDeleteAll(m_data);
         m_data.clear();
         endRemoveRows();
@@ -221,6 +229,12 @@ void RulesModel::reload()
                     if (actionVariant.canConvert<QmlObject::Ptr>()) {
                         int index = actions->count();
                         QmlObject::Ptr action = actionVariant.value<QmlObject::Ptr>();
+                        if (action->type() == "LazyAction" && action->hasProperty("component")) {
+                            action = action->property("component").value<QmlObject::Ptr>();
+                            if (action.isNull()) {
+                                continue;
+                            }
+                        }
                         RuleComponentModel *actionModel = actions->createTempComponent(PhoneBotHelper::Action,
                                                                                        index, action->type());
                         populateRuleComponentModel(actionModel, action, mappers);
@@ -42,7 +42,7 @@ class AbstractMapper : public QObject
     Q_PROPERTY(QVariant value READ value NOTIFY valueChanged)
 public:
     virtual ~AbstractMapper();
-    QVariant value() const;
+    virtual QVariant value() const;
 Q_SIGNALS:
     void valueChanged();
 protected:
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "clock.h"
+#include "clocktimer.h"
+#include "clocktimer_p.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimerEvent>
+
+class SystemClock : public Clock
+{
+public:
+    explicit SystemClock();
+    ~SystemClock();
+    bool isSimulated() const override;
+    qint64 now() const override;
+    qint64 elapsed() const override;
+protected:
+    void schedule(ClockTimer *timer, int msec) override;
+    void cancel(ClockTimer *timer) override;
+    void timerEvent(QTimerEvent *event) override;
+private:
+    QElapsedTimer m_clock;
+    QHash<int, ClockTimer *> m_timers;
+    QHash<ClockTimer *, int> m_timerIds;
+};
+
+struct ThreadClock
+{
+    ThreadClock() : system(nullptr) {}
+    ~ThreadClock() { delete system; }
+    SystemClock *system;
+    QPointer<Clock> installed;
+};
+
+static QThreadStorage<ThreadClock *> clocks;
+
+static ThreadClock * threadClock()
+{
+    if (!clocks.hasLocalData()) {
+        clocks.setLocalData(new ThreadClock());
+    }
+    return clocks.localData();
+}
+
+SystemClock::SystemClock()
+{
+    m_clock.start();
+}
+
+SystemClock::~SystemClock()
+{
+    foreach (ClockTimer *timer, m_timerIds.keys()) {
+        timer->stop();
+    }
+}
+
+bool SystemClock::isSimulated() const
+{
+    return false;
+}
+
+qint64 SystemClock::now() const
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+qint64 SystemClock::elapsed() const
+{
+    return m_clock.elapsed();
+}
+
+void SystemClock::schedule(ClockTimer *timer, int msec)
+{
+    int id = startTimer(msec, timer->timerType());
+    if (id == 0) {
+        return;
+    }
+    m_timers.insert(id, timer);
+    m_timerIds.insert(timer, id);
+}
+
+void SystemClock::cancel(ClockTimer *timer)
+{
+    int id = m_timerIds.take(timer);
+    if (id != 0) {
+        killTimer(id);
+        m_timers.remove(id);
+    }
+}
+
+void SystemClock::timerEvent(QTimerEvent *event)
+{
+    ClockTimer *timer = m_timers.take(event->timerId());
+    killTimer(event->timerId());
+    if (timer) {
+        m_timerIds.remove(timer);
+        fire(timer);
+    }
+}
+
+Clock::Clock(QObject *parent)
+    : QObject(parent)
+{
+}
+
+Clock::~Clock()
+{
+}
+
+Clock * Clock::instance()
+{
+    ThreadClock *clock = threadClock();
+    if (!clock->installed.isNull()) {
+        return clock->installed.data();
+    }
+    if (!clock->system) {
+        clock->system = new SystemClock();
+    }
+    return clock->system;
+}
+
+void Clock::setInstance(Clock *clock)
+{
+    // Passing null restores the system clock
+    threadClock()->installed = clock;
+}
+
+QDateTime Clock::currentDateTime() const
+{
+    return QDateTime::fromMSecsSinceEpoch(now());
+}
+
+QDate Clock::currentDate() const
+{
+    return currentDateTime().date();
+}
+
+QTime Clock::currentTime() const
+{
+    return currentDateTime().time();
+}
+
+void Clock::fire(ClockTimer *timer)
+{
+    ClockTimerPrivate *d = timer->d_func();
+    if (d->singleShot) {
+        d->active = false;
+    } else if (d->clock) {
+        d->clock->schedule(timer, d->interval);
+    }
+    emit timer->timeout();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+
+class ClockTimer;
+
+// Source of time for the time-dependent components
+//
+// Each thread uses the system clock, unless another clock is installed
+// with setInstance(). Components read the time with instance() when
+// they need it, and ClockTimer binds to the clock when it is started,
+// so a clock should be installed before creating rules.
+class Clock : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Clock(QObject *parent = 0);
+    virtual ~Clock();
+    static Clock * instance();
+    static void setInstance(Clock *clock);
+    virtual bool isSimulated() const = 0;
+    virtual qint64 now() const = 0; // In msecs since epoch
+    virtual qint64 elapsed() const = 0; // Monotonic, in msecs
+    QDateTime currentDateTime() const;
+    QDate currentDate() const;
+    QTime currentTime() const;
+protected:
+    virtual void schedule(ClockTimer *timer, int msec) = 0;
+    virtual void cancel(ClockTimer *timer) = 0;
+    static void fire(ClockTimer *timer);
+private:
+    friend class ClockTimer;
+};
+
+#endif // CLOCK_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "clocktimer.h"
+#include "clocktimer_p.h"
+
+ClockTimerPrivate::ClockTimerPrivate()
+    : interval(0), singleShot(false), active(false), timerType(Qt::CoarseTimer)
+{
+}
+
+ClockTimer::ClockTimer(QObject *parent)
+    : QObject(parent), d_ptr(new ClockTimerPrivate())
+{
+}
+
+ClockTimer::~ClockTimer()
+{
+    stop();
+}
+
+Clock * ClockTimer::clock() const
+{
+    Q_D(const ClockTimer);
+    return d->clock.isNull() ? Clock::instance() : d->clock.data();
+}
+
+bool ClockTimer::isActive() const
+{
+    Q_D(const ClockTimer);
+    return d->active && !d->clock.isNull();
+}
+
+bool ClockTimer::isSingleShot() const
+{
+    Q_D(const ClockTimer);
+    return d->singleShot;
+}
+
+void ClockTimer::setSingleShot(bool singleShot)
+{
+    Q_D(ClockTimer);
+    d->singleShot = singleShot;
+}
+
+int ClockTimer::interval() const
+{
+    Q_D(const ClockTimer);
+    return d->interval;
+}
+
+void ClockTimer::setInterval(int interval)
+{
+    Q_D(ClockTimer);
+    d->interval = qMax(0, interval);
+    if (isActive()) {
+        start();
+    }
+}
+
+Qt::TimerType ClockTimer::timerType() const
+{
+    Q_D(const ClockTimer);
+    return d->timerType;
+}
+
+void ClockTimer::setTimerType(Qt::TimerType timerType)
+{
+    Q_D(ClockTimer);
+    d->timerType = timerType;
+}
+
+void ClockTimer::start()
+{
+    Q_D(ClockTimer);
+    stop();
+    d->clock = Clock::instance();
+    d->active = true;
+    d->clock->schedule(this, d->interval);
+}
+
+void ClockTimer::start(int msec)
+{
+    Q_D(ClockTimer);
+    d->interval = qMax(0, msec);
+    start();
+}
+
+void ClockTimer::stop()
+{
+    Q_D(ClockTimer);
+    if (d->active && !d->clock.isNull()) {
+        d->clock->cancel(this);
+    }
+    d->active = false;
+}
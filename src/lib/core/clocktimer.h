@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef CLOCKTIMER_H
+#define CLOCKTIMER_H
+
+#include <QtCore/QObject>
+
+class Clock;
+class ClockTimerPrivate;
+
+// Timer driven by a Clock, with the same API as QTimer
+//
+// The timer uses the clock of its thread at the time it is started.
+// With a simulated clock, it only fires when the clock is advanced.
+class ClockTimer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ClockTimer(QObject *parent = 0);
+    virtual ~ClockTimer();
+    Clock * clock() const;
+    bool isActive() const;
+    bool isSingleShot() const;
+    void setSingleShot(bool singleShot);
+    int interval() const; // In msecs
+    void setInterval(int interval);
+    Qt::TimerType timerType() const;
+    void setTimerType(Qt::TimerType timerType);
+public Q_SLOTS:
+    void start();
+    void start(int msec);
+    void stop();
+Q_SIGNALS:
+    void timeout();
+protected:
+    QScopedPointer<ClockTimerPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(ClockTimer)
+    friend class Clock;
+};
+
+#endif // CLOCKTIMER_H
@@ -36,6 +36,7 @@
 #include <QtQml/QQmlParserStatus>
 
 class Rule;
+class TriggerEvent;
 class ConditionPrivate;
 class Condition: public QObject, public QQmlParserStatus
 {
@@ -49,7 +50,7 @@ public:
     void componentComplete() override;
     bool isEnabled() const;
     void setEnabled(bool enabled);
-    virtual bool isValid(Rule *rule) = 0;
+    virtual bool isValid(Rule *rule, TriggerEvent *event) = 0;
 Q_SIGNALS:
     void enabledChanged();
 protected:
@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "continuationscheduler.h"
+#include "clock.h"
+#include "clocktimer.h"
+#include "phonebotlogging.h"
+#include "sequenceaction.h"
+#include "trigger.h"
+#include "triggerevent.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMultiMap>
+#include <QtCore/QPointer>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimer>
+
+static const char *CONTINUATIONS_KEY = "continuations";
+static const char *KEY_KEY = "key";
+static const char *STEP_KEY = "step";
+static const char *DEADLINE_KEY = "deadline";
+static const char *TIMESTAMP_KEY = "timestamp";
+static const char *PAYLOAD_KEY = "payload";
+static const int MAX_TIMER_INTERVAL = 3600000; // 1 hour in msecs
+static const int COARSE_TIMER_THRESHOLD = 60000; // 1 minute in msecs
+static const int SAVE_DELAY = 1000; // In msecs
+
+struct Continuation
+{
+    QString key;
+    QPointer<SequenceAction> sequence;
+    int step;
+    QPointer<Trigger> trigger;
+    QDateTime timestamp;
+    QVariantMap payload;
+};
+
+class ContinuationSchedulerPrivate
+{
+public:
+    explicit ContinuationSchedulerPrivate(ContinuationScheduler *q);
+    void load();
+    void scheduleSave();
+    void save();
+    void restart();
+    void notify(qint64 oldDeadline, int oldCount);
+    qint64 firstDeadline() const;
+    // Continuations are sorted by deadline, in msecs since epoch,
+    // so that they can be persisted and restored across restarts
+    QMultiMap<qint64, Continuation> continuations;
+    QString storagePath;
+    ClockTimer *timer;
+    QTimer *saveTimer;
+    bool dirty;
+protected:
+    ContinuationScheduler * const q_ptr;
+private:
+    Q_DECLARE_PUBLIC(ContinuationScheduler)
+};
+
+static QThreadStorage<ContinuationScheduler *> schedulers;
+
+ContinuationSchedulerPrivate::ContinuationSchedulerPrivate(ContinuationScheduler *q)
+    : timer(0), saveTimer(0), dirty(false), q_ptr(q)
+{
+}
+
+void ContinuationSchedulerPrivate::load()
+{
+    QFile file (storagePath);
+    if (!file.exists()) {
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(phonebotCore) << "Failed to read continuations from" << storagePath;
+        return;
+    }
+
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    QJsonArray array = document.object().value(CONTINUATIONS_KEY).toArray();
+    for (const QJsonValue &value : array) {
+        QJsonObject object = value.toObject();
+        Continuation continuation;
+        continuation.key = object.value(KEY_KEY).toString();
+        continuation.step = object.value(STEP_KEY).toInt();
+        continuation.timestamp = QDateTime::fromMSecsSinceEpoch(object.value(TIMESTAMP_KEY).toVariant().toLongLong());
+        continuation.payload = object.value(PAYLOAD_KEY).toObject().toVariantMap();
+        if (continuation.key.isEmpty()) {
+            continue;
+        }
+
+        // Restored continuations stay unbound until
+        // their sequence is attached again
+        qint64 deadline = object.value(DEADLINE_KEY).toVariant().toLongLong();
+        continuations.insert(deadline, continuation);
+    }
+}
+
+void ContinuationSchedulerPrivate::scheduleSave()
+{
+    // Sequences are scheduled and cancelled in bursts when
+    // rules run, so writes are grouped on a short delay
+    dirty = true;
+    if (!saveTimer->isActive()) {
+        saveTimer->start();
+    }
+}
+
+void ContinuationSchedulerPrivate::save()
+{
+    saveTimer->stop();
+    dirty = false;
+    if (storagePath.isEmpty()) {
+        return;
+    }
+
+    // Only continuations with a key can be matched
+    // with their sequence when they are restored
+    QJsonArray array;
+    for (QMultiMap<qint64, Continuation>::const_iterator i = continuations.begin();
+         i != continuations.end(); ++i) {
+        if (i->key.isEmpty()) {
+            continue;
+        }
+
+        QJsonObject object;
+        object.insert(KEY_KEY, i->key);
+        object.insert(STEP_KEY, i->step);
+        object.insert(DEADLINE_KEY, QJsonValue::fromVariant(i.key()));
+        object.insert(TIMESTAMP_KEY, QJsonValue::fromVariant(i->timestamp.toMSecsSinceEpoch()));
+        object.insert(PAYLOAD_KEY, QJsonObject::fromVariantMap(i->payload));
+        array.append(object);
+    }
+
+    QJsonObject root;
+    root.insert(CONTINUATIONS_KEY, array);
+
+    QDir().mkpath(QFileInfo(storagePath).absolutePath());
+    QSaveFile file (storagePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(phonebotCore) << "Failed to write continuations to" << storagePath;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qCWarning(phonebotCore) << "Failed to write continuations to" << storagePath;
+    }
+}
+
+void ContinuationSchedulerPrivate::restart()
+{
+    qint64 deadline = firstDeadline();
+    if (deadline < 0) {
+        timer->stop();
+        return;
+    }
+
+    // Long delays are handled by a coarse timer that is re-armed at
+    // most every hour. When the device is suspended, due continuations
+    // are also processed on the time plugin's wake ups.
+    qint64 delta = qMax<qint64>(0, deadline - Clock::instance()->now());
+    Qt::TimerType type = delta > COARSE_TIMER_THRESHOLD ? Qt::VeryCoarseTimer : Qt::CoarseTimer;
+    if (timer->timerType() != type) {
+        timer->stop();
+        timer->setTimerType(type);
+    }
+    timer->start(static_cast<int>(qMin<qint64>(delta, MAX_TIMER_INTERVAL)));
+}
+
+void ContinuationSchedulerPrivate::notify(qint64 oldDeadline, int oldCount)
+{
+    Q_Q(ContinuationScheduler);
+    restart();
+    if (continuations.count() != oldCount) {
+        emit q->countChanged();
+    }
+    if (firstDeadline() != oldDeadline) {
+        emit q->nextDeadlineChanged();
+    }
+}
+
+qint64 ContinuationSchedulerPrivate::firstDeadline() const
+{
+    // Unbound continuations are only run once their
+    // sequence is attached, they don't need to wake up
+    for (QMultiMap<qint64, Continuation>::const_iterator i = continuations.begin();
+         i != continuations.end(); ++i) {
+        if (!i->sequence.isNull() || i->key.isEmpty()) {
+            return i.key();
+        }
+    }
+    return -1;
+}
+
+ContinuationScheduler::ContinuationScheduler(QObject *parent)
+    : QObject(parent), d_ptr(new ContinuationSchedulerPrivate(this))
+{
+    Q_D(ContinuationScheduler);
+    d->timer = new ClockTimer(this);
+    d->timer->setSingleShot(true);
+    connect(d->timer, &ClockTimer::timeout, this, &ContinuationScheduler::processDue);
+    // Saving is I/O, it follows the real time, even with a simulated clock
+    d->saveTimer = new QTimer(this);
+    d->saveTimer->setSingleShot(true);
+    d->saveTimer->setInterval(SAVE_DELAY);
+    connect(d->saveTimer, &QTimer::timeout, this, &ContinuationScheduler::flush);
+}
+
+ContinuationScheduler::~ContinuationScheduler()
+{
+    flush();
+}
+
+ContinuationScheduler * ContinuationScheduler::instance()
+{
+    // Sequences living in the same thread share a single scheduler
+    if (!schedulers.hasLocalData()) {
+        schedulers.setLocalData(new ContinuationScheduler());
+    }
+    return schedulers.localData();
+}
+
+QString ContinuationScheduler::storagePath() const
+{
+    Q_D(const ContinuationScheduler);
+    return d->storagePath;
+}
+
+void ContinuationScheduler::setStoragePath(const QString &storagePath)
+{
+    Q_D(ContinuationScheduler);
+    if (d->storagePath == storagePath) {
+        return;
+    }
+
+    // Pending changes belong to the previous file
+    flush();
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    d->storagePath = storagePath;
+    d->load();
+    d->save();
+    d->notify(oldDeadline, oldCount);
+}
+
+int ContinuationScheduler::count() const
+{
+    Q_D(const ContinuationScheduler);
+    return d->continuations.count();
+}
+
+QDateTime ContinuationScheduler::nextDeadline() const
+{
+    Q_D(const ContinuationScheduler);
+    qint64 deadline = d->firstDeadline();
+    if (deadline < 0) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(deadline);
+}
+
+void ContinuationScheduler::schedule(SequenceAction *sequence, int step, const QDateTime &deadline,
+                                     TriggerEvent *event)
+{
+    Q_D(ContinuationScheduler);
+    if (!sequence) {
+        return;
+    }
+
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    Continuation continuation;
+    continuation.key = sequence->key();
+    continuation.sequence = sequence;
+    continuation.step = step;
+    continuation.trigger = event ? event->trigger() : nullptr;
+    continuation.timestamp = event ? event->timestamp() : Clock::instance()->currentDateTime();
+    continuation.payload = event ? event->payload() : QVariantMap();
+    d->continuations.insert(deadline.toMSecsSinceEpoch(), continuation);
+    if (!continuation.key.isEmpty()) {
+        d->scheduleSave();
+    }
+    d->notify(oldDeadline, oldCount);
+}
+
+void ContinuationScheduler::cancel(SequenceAction *sequence)
+{
+    Q_D(ContinuationScheduler);
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    bool keyedRemoved = false;
+    QMultiMap<qint64, Continuation>::iterator i = d->continuations.begin();
+    while (i != d->continuations.end()) {
+        if (i->sequence == sequence
+            || (i->sequence.isNull() && !i->key.isEmpty() && i->key == sequence->key())) {
+            keyedRemoved = keyedRemoved || !i->key.isEmpty();
+            i = d->continuations.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    if (keyedRemoved) {
+        d->scheduleSave();
+    }
+    if (d->continuations.count() != oldCount) {
+        d->notify(oldDeadline, oldCount);
+    }
+}
+
+void ContinuationScheduler::attach(SequenceAction *sequence)
+{
+    Q_D(ContinuationScheduler);
+    if (!sequence || sequence->key().isEmpty()) {
+        return;
+    }
+
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    for (Continuation &continuation : d->continuations) {
+        if (continuation.key == sequence->key()) {
+            continuation.sequence = sequence;
+        }
+    }
+
+    // Continuations that are already due are run from
+    // the timer, once the sequence is fully set up
+    d->notify(oldDeadline, oldCount);
+}
+
+void ContinuationScheduler::discardUnbound()
+{
+    Q_D(ContinuationScheduler);
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    bool keyedRemoved = false;
+    QMultiMap<qint64, Continuation>::iterator i = d->continuations.begin();
+    while (i != d->continuations.end()) {
+        if (i->sequence.isNull()) {
+            keyedRemoved = keyedRemoved || !i->key.isEmpty();
+            i = d->continuations.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    if (keyedRemoved) {
+        d->scheduleSave();
+    }
+    if (d->continuations.count() != oldCount) {
+        d->notify(oldDeadline, oldCount);
+    }
+}
+
+void ContinuationScheduler::flush()
+{
+    Q_D(ContinuationScheduler);
+    if (d->dirty) {
+        d->save();
+    }
+}
+
+void ContinuationScheduler::processDue()
+{
+    Q_D(ContinuationScheduler);
+    qint64 oldDeadline = d->firstDeadline();
+    int oldCount = d->continuations.count();
+    qint64 current = Clock::instance()->now();
+
+    // Continuations whose sequence is not known yet are kept,
+    // and anonymous ones whose sequence is gone are dropped
+    QList<Continuation> due;
+    bool keyedRemoved = false;
+    QMultiMap<qint64, Continuation>::iterator i = d->continuations.begin();
+    while (i != d->continuations.end() && i.key() <= current) {
+        if (!i->sequence.isNull()) {
+            keyedRemoved = keyedRemoved || !i->key.isEmpty();
+            due.append(*i);
+            i = d->continuations.erase(i);
+        } else if (i->key.isEmpty()) {
+            i = d->continuations.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    if (keyedRemoved) {
+        d->scheduleSave();
+    }
+    d->notify(oldDeadline, oldCount);
+
+    for (const Continuation &continuation : due) {
+        if (!continuation.sequence.isNull()) {
+            TriggerEvent event (continuation.trigger, continuation.timestamp, continuation.payload);
+            continuation.sequence->resume(continuation.step, &event);
+        }
+    }
+}
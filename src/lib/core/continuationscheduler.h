@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef CONTINUATIONSCHEDULER_H
+#define CONTINUATIONSCHEDULER_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+
+class SequenceAction;
+class TriggerEvent;
+class ContinuationSchedulerPrivate;
+class ContinuationScheduler : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(QDateTime nextDeadline READ nextDeadline NOTIFY nextDeadlineChanged)
+public:
+    virtual ~ContinuationScheduler();
+    static ContinuationScheduler * instance();
+    QString storagePath() const;
+    void setStoragePath(const QString &storagePath);
+    int count() const;
+    QDateTime nextDeadline() const;
+    void schedule(SequenceAction *sequence, int step, const QDateTime &deadline, TriggerEvent *event);
+    void cancel(SequenceAction *sequence);
+    void attach(SequenceAction *sequence);
+    void discardUnbound();
+    void flush();
+public Q_SLOTS:
+    void processDue();
+Q_SIGNALS:
+    void countChanged();
+    void nextDeadlineChanged();
+protected:
+    explicit ContinuationScheduler(QObject *parent = 0);
+    QScopedPointer<ContinuationSchedulerPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(ContinuationScheduler)
+};
+
+#endif // CONTINUATIONSCHEDULER_H
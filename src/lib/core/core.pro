@@ -11,9 +11,23 @@ CONFIG += staticlib
 include(../../config.pri)
 
 HEADERS = rule.h \
+    clock.h \
+    clocktimer.h \
+    clocktimer_p.h \
+    virtualclock.h \
+    abstractrulefactory.h \
     rule_p.h \
+    ruledispatcher.h \
     trigger.h \
     trigger_p.h \
+    triggerevent.h \
+    triggeringress.h \
+    triggerrecorder.h \
+    triggertraceformat.h \
+    triggertracereader.h \
+    executionjournal.h \
+    executionjournalformat.h \
+    mpscqueue.h \
     action.h \
     condition.h \
     condition_p.h \
@@ -22,19 +36,47 @@ HEADERS = rule.h \
     phonebotengine.h \
     phonebotextensioninterface.h \
     phonebotextensionplugin.h \
+    phonebotlogging.h \
     jsaction.h \
     jscondition.h \
+    scriptwatchdog.h \
+    lazyaction.h \
+    sequenceaction.h \
+    delayaction.h \
+    continuationscheduler.h \
     abstractmapper.h \
     abstractmapper_p.h \
-    timemapper.h
+    typedmapper.h \
+    timemapper.h \
+    datetimemapper.h \
+    durationmapper.h \
+    daymaskmapper.h
 
 SOURCES = rule.cpp \
+    clock.cpp \
+    clocktimer.cpp \
+    virtualclock.cpp \
+    ruledispatcher.cpp \
     trigger.cpp \
+    triggerevent.cpp \
+    triggeringress.cpp \
+    triggerrecorder.cpp \
+    triggertracereader.cpp \
+    executionjournal.cpp \
     action.cpp \
     condition.cpp \
     phonebotengine.cpp \
     phonebotextensionplugin.cpp \
+    phonebotlogging.cpp \
     jsaction.cpp \
     jscondition.cpp \
+    scriptwatchdog.cpp \
+    lazyaction.cpp \
+    sequenceaction.cpp \
+    delayaction.cpp \
+    continuationscheduler.cpp \
     abstractmapper.cpp \
-    timemapper.cpp
+    timemapper.cpp \
+    datetimemapper.cpp \
+    durationmapper.cpp \
+    daymaskmapper.cpp
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "datetimemapper.h"
+#include "abstractmapper_p.h"
+
+class DateTimeMapperPrivate: public AbstractMapperPrivate
+{
+public:
+    explicit DateTimeMapperPrivate(DateTimeMapper *q);
+    void update();
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+private:
+    Q_DECLARE_PUBLIC(DateTimeMapper)
+};
+
+DateTimeMapperPrivate::DateTimeMapperPrivate(DateTimeMapper *q)
+    : AbstractMapperPrivate(q)
+    , year(-1)
+    , month(-1)
+    , day(-1)
+    , hour(-1)
+    , minute(-1)
+{
+}
+
+void DateTimeMapperPrivate::update()
+{
+    Q_Q(DateTimeMapper);
+    QDate date (year, month, day);
+    QTime time (hour, minute);
+    if (date.isValid() && time.isValid()) {
+        q->setTypedValue(QDateTime(date, time));
+    } else {
+        q->setTypedValue(QDateTime());
+    }
+}
+
+DateTimeMapper::DateTimeMapper(QObject *parent) :
+    TypedMapper<QDateTime>(*(new DateTimeMapperPrivate(this)), parent)
+{
+}
+
+QDateTime DateTimeMapper::dateTime() const
+{
+    return typedValue();
+}
+
+int DateTimeMapper::year() const
+{
+    Q_D(const DateTimeMapper);
+    return d->year;
+}
+
+void DateTimeMapper::setYear(int year)
+{
+    Q_D(DateTimeMapper);
+    if (d->year != year) {
+        d->year = year;
+        d->update();
+        emit yearChanged();
+    }
+}
+
+int DateTimeMapper::month() const
+{
+    Q_D(const DateTimeMapper);
+    return d->month;
+}
+
+void DateTimeMapper::setMonth(int month)
+{
+    Q_D(DateTimeMapper);
+    if (d->month != month) {
+        d->month = month;
+        d->update();
+        emit monthChanged();
+    }
+}
+
+int DateTimeMapper::day() const
+{
+    Q_D(const DateTimeMapper);
+    return d->day;
+}
+
+void DateTimeMapper::setDay(int day)
+{
+    Q_D(DateTimeMapper);
+    if (d->day != day) {
+        d->day = day;
+        d->update();
+        emit dayChanged();
+    }
+}
+
+int DateTimeMapper::hour() const
+{
+    Q_D(const DateTimeMapper);
+    return d->hour;
+}
+
+void DateTimeMapper::setHour(int hour)
+{
+    Q_D(DateTimeMapper);
+    if (d->hour != hour) {
+        d->hour = hour;
+        d->update();
+        emit hourChanged();
+    }
+}
+
+int DateTimeMapper::minute() const
+{
+    Q_D(const DateTimeMapper);
+    return d->minute;
+}
+
+void DateTimeMapper::setMinute(int minute)
+{
+    Q_D(DateTimeMapper);
+    if (d->minute != minute) {
+        d->minute = minute;
+        d->update();
+        emit minuteChanged();
+    }
+}
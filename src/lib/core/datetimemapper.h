@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef DATETIMEMAPPER_H
+#define DATETIMEMAPPER_H
+
+#include <QtCore/QDateTime>
+#include "typedmapper.h"
+
+class DateTimeMapperPrivate;
+class DateTimeMapper : public TypedMapper<QDateTime>
+{
+    Q_OBJECT
+    Q_PROPERTY(int year READ year WRITE setYear NOTIFY yearChanged)
+    Q_PROPERTY(int month READ month WRITE setMonth NOTIFY monthChanged)
+    Q_PROPERTY(int day READ day WRITE setDay NOTIFY dayChanged)
+    Q_PROPERTY(int hour READ hour WRITE setHour NOTIFY hourChanged)
+    Q_PROPERTY(int minute READ minute WRITE setMinute NOTIFY minuteChanged)
+    Q_PROPERTY(QDateTime dateTime READ dateTime NOTIFY valueChanged)
+public:
+    explicit DateTimeMapper(QObject *parent = 0);
+    QDateTime dateTime() const;
+    int year() const;
+    void setYear(int year);
+    int month() const;
+    void setMonth(int month);
+    int day() const;
+    void setDay(int day);
+    int hour() const;
+    void setHour(int hour);
+    int minute() const;
+    void setMinute(int minute);
+Q_SIGNALS:
+    void yearChanged();
+    void monthChanged();
+    void dayChanged();
+    void hourChanged();
+    void minuteChanged();
+private:
+    Q_DECLARE_PRIVATE(DateTimeMapper)
+};
+
+#endif // DATETIMEMAPPER_H
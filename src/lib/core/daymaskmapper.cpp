@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "daymaskmapper.h"
+#include "abstractmapper_p.h"
+#include <QtCore/QStringList>
+
+class DayMaskMapperPrivate: public AbstractMapperPrivate
+{
+public:
+    explicit DayMaskMapperPrivate(DayMaskMapper *q);
+    void update();
+    QString days;
+private:
+    Q_DECLARE_PUBLIC(DayMaskMapper)
+};
+
+DayMaskMapperPrivate::DayMaskMapperPrivate(DayMaskMapper *q)
+    : AbstractMapperPrivate(q)
+{
+}
+
+void DayMaskMapperPrivate::update()
+{
+    Q_Q(DayMaskMapper);
+    // Days are a comma separated list of ISO
+    // day numbers, 1 being Monday and 7 Sunday
+    int mask = 0;
+    for (const QString &day : days.split(",", QString::SkipEmptyParts)) {
+        bool ok = false;
+        int dayNumber = day.trimmed().toInt(&ok);
+        if (ok && dayNumber >= Qt::Monday && dayNumber <= Qt::Sunday) {
+            mask |= 1 << (dayNumber - Qt::Monday);
+        }
+    }
+    q->setTypedValue(mask);
+}
+
+DayMaskMapper::DayMaskMapper(QObject *parent) :
+    TypedMapper<int>(*(new DayMaskMapperPrivate(this)), parent)
+{
+}
+
+int DayMaskMapper::mask() const
+{
+    return typedValue();
+}
+
+QString DayMaskMapper::days() const
+{
+    Q_D(const DayMaskMapper);
+    return d->days;
+}
+
+void DayMaskMapper::setDays(const QString &days)
+{
+    Q_D(DayMaskMapper);
+    if (d->days != days) {
+        d->days = days;
+        d->update();
+        emit daysChanged();
+    }
+}
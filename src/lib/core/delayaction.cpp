@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "delayaction.h"
+#include "action_p.h"
+#include "phonebotlogging.h"
+
+class DelayActionPrivate: public ActionPrivate
+{
+public:
+    explicit DelayActionPrivate(Action *q);
+    int duration;
+private:
+    Q_DECLARE_PUBLIC(DelayAction)
+};
+
+DelayActionPrivate::DelayActionPrivate(Action *q)
+    : ActionPrivate(q), duration(0)
+{
+}
+
+DelayAction::DelayAction(QObject *parent) :
+    Action(*(new DelayActionPrivate(this)), parent)
+{
+}
+
+int DelayAction::duration() const
+{
+    Q_D(const DelayAction);
+    return d->duration;
+}
+
+void DelayAction::setDuration(int duration)
+{
+    Q_D(DelayAction);
+    if (d->duration != duration) {
+        d->duration = duration;
+        emit durationChanged();
+    }
+}
+
+bool DelayAction::execute(Rule *rule, TriggerEvent *event)
+{
+    Q_UNUSED(rule)
+    Q_UNUSED(event)
+    // Delays are handled by the enclosing sequence
+    qCWarning(phonebotCore) << "DelayAction: delays are only supported inside a SequenceAction";
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "durationmapper.h"
+#include "abstractmapper_p.h"
+
+class DurationMapperPrivate: public AbstractMapperPrivate
+{
+public:
+    explicit DurationMapperPrivate(DurationMapper *q);
+    void update();
+    int hours;
+    int minutes;
+    int seconds;
+private:
+    Q_DECLARE_PUBLIC(DurationMapper)
+};
+
+DurationMapperPrivate::DurationMapperPrivate(DurationMapper *q)
+    : AbstractMapperPrivate(q)
+    , hours(0)
+    , minutes(0)
+    , seconds(0)
+{
+}
+
+void DurationMapperPrivate::update()
+{
+    Q_Q(DurationMapper);
+    q->setTypedValue(((hours * 60 + minutes) * 60 + seconds) * 1000);
+}
+
+DurationMapper::DurationMapper(QObject *parent) :
+    TypedMapper<int>(*(new DurationMapperPrivate(this)), parent)
+{
+}
+
+int DurationMapper::duration() const
+{
+    return typedValue();
+}
+
+int DurationMapper::hours() const
+{
+    Q_D(const DurationMapper);
+    return d->hours;
+}
+
+void DurationMapper::setHours(int hours)
+{
+    Q_D(DurationMapper);
+    if (d->hours != hours) {
+        d->hours = hours;
+        d->update();
+        emit hoursChanged();
+    }
+}
+
+int DurationMapper::minutes() const
+{
+    Q_D(const DurationMapper);
+    return d->minutes;
+}
+
+void DurationMapper::setMinutes(int minutes)
+{
+    Q_D(DurationMapper);
+    if (d->minutes != minutes) {
+        d->minutes = minutes;
+        d->update();
+        emit minutesChanged();
+    }
+}
+
+int DurationMapper::seconds() const
+{
+    Q_D(const DurationMapper);
+    return d->seconds;
+}
+
+void DurationMapper::setSeconds(int seconds)
+{
+    Q_D(DurationMapper);
+    if (d->seconds != seconds) {
+        d->seconds = seconds;
+        d->update();
+        emit secondsChanged();
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef DURATIONMAPPER_H
+#define DURATIONMAPPER_H
+
+#include "typedmapper.h"
+
+class DurationMapperPrivate;
+class DurationMapper : public TypedMapper<int>
+{
+    Q_OBJECT
+    Q_PROPERTY(int hours READ hours WRITE setHours NOTIFY hoursChanged)
+    Q_PROPERTY(int minutes READ minutes WRITE setMinutes NOTIFY minutesChanged)
+    Q_PROPERTY(int seconds READ seconds WRITE setSeconds NOTIFY secondsChanged)
+    Q_PROPERTY(int duration READ duration NOTIFY valueChanged)
+public:
+    explicit DurationMapper(QObject *parent = 0);
+    int duration() const; // In milliseconds
+    int hours() const;
+    void setHours(int hours);
+    int minutes() const;
+    void setMinutes(int minutes);
+    int seconds() const;
+    void setSeconds(int seconds);
+Q_SIGNALS:
+    void hoursChanged();
+    void minutesChanged();
+    void secondsChanged();
+private:
+    Q_DECLARE_PRIVATE(DurationMapper)
+};
+
+#endif // DURATIONMAPPER_H
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "executionjournal.h"
+#include "executionjournalformat.h"
+#include "phonebotlogging.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+#include <cstring>
+#include <new>
+
+static const qint64 NSECS_PER_MSEC = 1000000;
+
+class ExecutionJournalPrivate
+{
+public:
+    explicit ExecutionJournalPrivate();
+    bool map(const QString &path, int capacity, int nameSlots);
+    QFile file;
+    uchar *data;
+    JournalHeader *header;
+    JournalName *names;
+    JournalRecord *records;
+    int nameSlots;
+    QMutex namesMutex;
+    QSet<quint32> droppedNames;
+    QElapsedTimer clock;
+    qint64 startTime; // In nsecs since epoch
+};
+
+static ExecutionJournal *journal = nullptr;
+
+ExecutionJournalPrivate::ExecutionJournalPrivate()
+    : data(nullptr), header(nullptr), names(nullptr), records(nullptr), nameSlots(0), startTime(0)
+{
+}
+
+// The name table is kept at most half full, so that
+// probing stays short, and rules can be added
+static int nameSlotsForRules(int ruleCount)
+{
+    int nameSlots = JOURNAL_NAME_SLOTS;
+    while (nameSlots < 2 * ruleCount) {
+        nameSlots *= 2;
+    }
+    return nameSlots;
+}
+
+bool ExecutionJournalPrivate::map(const QString &path, int capacity, int nameSlots)
+{
+    this->nameSlots = nameSlots;
+    qint64 size = sizeof(JournalHeader) + qint64(nameSlots) * sizeof(JournalName)
+                  + qint64(capacity) * sizeof(JournalRecord);
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qCWarning(phonebotCore) << "Failed to open the execution journal" << path;
+        return false;
+    }
+
+    // A journal with another layout is started again
+    bool compatible = file.size() == size;
+    if (!compatible && !file.resize(size)) {
+        qCWarning(phonebotCore) << "Failed to resize the execution journal" << path;
+        return false;
+    }
+
+    data = file.map(0, size);
+    if (!data) {
+        qCWarning(phonebotCore) << "Failed to map the execution journal" << path;
+        return false;
+    }
+
+    header = reinterpret_cast<JournalHeader *>(data);
+    names = reinterpret_cast<JournalName *>(data + sizeof(JournalHeader));
+    records = reinterpret_cast<JournalRecord *>(data + sizeof(JournalHeader)
+                                                + qint64(nameSlots) * sizeof(JournalName));
+    compatible = compatible && header->magic == JOURNAL_MAGIC && header->version == JOURNAL_VERSION
+                 && header->recordSize == sizeof(JournalRecord)
+                 && header->capacity == quint32(capacity)
+                 && header->nameSlots == quint32(nameSlots);
+    if (!compatible) {
+        std::memset(data, 0, size);
+        header->magic = JOURNAL_MAGIC;
+        header->version = JOURNAL_VERSION;
+        header->recordSize = sizeof(JournalRecord);
+        header->capacity = capacity;
+        header->nameSlots = nameSlots;
+        new (&header->writeIndex) std::atomic<quint64>(0);
+        for (int i = 0; i < capacity; ++i) {
+            new (&records[i].sequence) std::atomic<quint64>(0);
+        }
+    }
+
+    // The journal stays on the wall clock, and not on Clock::instance(): it
+    // is read post-mortem, to match records with the logs of the device
+    clock.start();
+    startTime = QDateTime::currentMSecsSinceEpoch() * NSECS_PER_MSEC;
+    return true;
+}
+
+ExecutionJournal::ExecutionJournal()
+    : d_ptr(new ExecutionJournalPrivate())
+{
+}
+
+ExecutionJournal::~ExecutionJournal()
+{
+    Q_D(ExecutionJournal);
+    if (d->data) {
+        d->file.unmap(d->data);
+    }
+}
+
+ExecutionJournal * ExecutionJournal::instance()
+{
+    return journal;
+}
+
+bool ExecutionJournal::open(const QString &path, int capacity, int ruleCount)
+{
+    close();
+    if (capacity <= 0) {
+        return false;
+    }
+
+    ExecutionJournal *newJournal = new ExecutionJournal();
+    if (!newJournal->d_func()->map(path, capacity, nameSlotsForRules(ruleCount))) {
+        delete newJournal;
+        return false;
+    }
+    journal = newJournal;
+    return true;
+}
+
+void ExecutionJournal::close()
+{
+    // Only to be called when no rule is running
+    delete journal;
+    journal = nullptr;
+}
+
+QString ExecutionJournal::path() const
+{
+    Q_D(const ExecutionJournal);
+    return d->file.fileName();
+}
+
+int ExecutionJournal::capacity() const
+{
+    Q_D(const ExecutionJournal);
+    return d->header->capacity;
+}
+
+quint32 ExecutionJournal::registerRule(const QString &name)
+{
+    Q_D(ExecutionJournal);
+    // FNV-1a, so that ids are stable across restarts
+    QByteArray utf8 = name.toUtf8();
+    quint32 id = 2166136261u;
+    for (char c : utf8) {
+        id = (id ^ quint8(c)) * 16777619u;
+    }
+    if (id == 0) {
+        id = 1;
+    }
+
+    QMutexLocker locker (&d->namesMutex);
+    for (int i = 0; i < d->nameSlots; ++i) {
+        JournalName &slot = d->names[(id + i) % d->nameSlots];
+        if (slot.id == id) {
+            return id;
+        }
+
+        if (slot.id == 0) {
+            // Names are truncated from the start, the end of a path is more relevant
+            QByteArray truncated = utf8.right(JOURNAL_NAME_SIZE - 1);
+            std::memcpy(slot.name, truncated.constData(), truncated.size());
+            slot.name[truncated.size()] = '\0';
+            slot.id = id;
+            return id;
+        }
+    }
+
+    // Rules keep registering when they are reloaded,
+    // so each dropped name is only counted once
+    if (!d->droppedNames.contains(id)) {
+        d->droppedNames.insert(id);
+        d->header->droppedNames = d->droppedNames.count();
+        qCWarning(phonebotCore) << "The name table of the execution journal is full, dropping" << name;
+    }
+    return id;
+}
+
+qint64 ExecutionJournal::now() const
+{
+    Q_D(const ExecutionJournal);
+    return d->clock.nsecsElapsed();
+}
+
+void ExecutionJournal::record(quint16 kind, quint32 rule, quint16 index, bool result, qint64 start)
+{
+    Q_D(ExecutionJournal);
+    // Lock-free, records can be written from any thread
+    qint64 end = d->clock.nsecsElapsed();
+    quint64 sequence = d->header->writeIndex.fetch_add(1, std::memory_order_relaxed);
+    JournalRecord &record = d->records[sequence % d->header->capacity];
+    // The slot is marked as being written before its fields change,
+    // so that readers of a live journal can detect torn records
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.time = d->startTime + start;
+    record.rule = rule;
+    bool saturated = end - start > Q_INT64_C(0xffffffff);
+    record.duration = saturated ? 0xffffffff : quint32(end - start);
+    record.kind = kind;
+    record.index = index;
+    record.result = result ? 1 : 0;
+    record.flags = saturated ? JOURNAL_DURATION_SATURATED : 0;
+    record.sequence.store(sequence + 1, std::memory_order_release);
+}
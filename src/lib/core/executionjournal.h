@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef EXECUTIONJOURNAL_H
+#define EXECUTIONJOURNAL_H
+
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+
+class ExecutionJournalPrivate;
+class ExecutionJournal
+{
+public:
+    virtual ~ExecutionJournal();
+    static ExecutionJournal * instance();
+    static bool open(const QString &path, int capacity, int ruleCount = 0);
+    static void close();
+    QString path() const;
+    int capacity() const;
+    quint32 registerRule(const QString &name);
+    qint64 now() const; // In nsecs
+    void record(quint16 kind, quint32 rule, quint16 index, bool result, qint64 start);
+protected:
+    explicit ExecutionJournal();
+    QScopedPointer<ExecutionJournalPrivate> d_ptr;
+private:
+    Q_DISABLE_COPY(ExecutionJournal)
+    Q_DECLARE_PRIVATE(ExecutionJournal)
+};
+
+#endif // EXECUTIONJOURNAL_H
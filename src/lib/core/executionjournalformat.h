@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef EXECUTIONJOURNALFORMAT_H
+#define EXECUTIONJOURNALFORMAT_H
+
+#include <QtCore/QtGlobal>
+#include <atomic>
+
+// On-disk layout of the execution journal. The file starts with a
+// header, followed by a table of rule names, then by a ring of fixed
+// size records. It is shared by the daemon and the offline reader.
+
+static const quint32 JOURNAL_MAGIC = 0x4a425450; // "PTBJ"
+static const quint32 JOURNAL_VERSION = 2;
+static const int JOURNAL_NAME_SIZE = 124;
+static const int JOURNAL_NAME_SLOTS = 256; // Minimum size of the name table
+
+// Flags of a record
+static const quint16 JOURNAL_DURATION_SATURATED = 0x1; // Longer than the duration field
+
+enum JournalRecordKind {
+    JournalTriggerFired = 1,
+    JournalConditionChecked = 2,
+    JournalActionExecuted = 3
+};
+
+struct JournalHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 recordSize;
+    quint32 capacity;
+    quint32 nameSlots;
+    // Names that did not fit in the table, their
+    // records only carry the id of the rule
+    quint32 droppedNames;
+    // Number of records ever written, the next record
+    // is written at writeIndex % capacity
+    std::atomic<quint64> writeIndex;
+};
+
+struct JournalName
+{
+    quint32 id;
+    char name[JOURNAL_NAME_SIZE];
+};
+
+struct JournalRecord
+{
+    // Index of the record plus one, set to 0 while the record
+    // is written, and written last, so that partially written
+    // records can be detected
+    std::atomic<quint64> sequence;
+    quint64 time; // In nsecs since epoch
+    quint32 rule;
+    quint32 duration; // In nsecs
+    quint16 kind;
+    quint16 index;
+    quint16 result;
+    quint16 flags;
+};
+
+#endif // EXECUTIONJOURNALFORMAT_H
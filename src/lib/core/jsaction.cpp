@@ -34,6 +34,9 @@
 #include <QtQml/QQmlContext>
 #include <QtQml/QQmlEngine>
 #include "rule.h"
+#include "rule_p.h"
+#include "scriptwatchdog.h"
+#include "triggerevent.h"
 
 class JsActionPrivate: public ActionPrivate
 {
@@ -69,7 +72,7 @@ void JsAction::setAction(const QJSValue &action)
     }
 }
 
-bool JsAction::execute(Rule *rule)
+bool JsAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_D(JsAction);
     if (!d->action.isCallable()) {
@@ -85,7 +88,15 @@ bool JsAction::execute(Rule *rule)
     QJSValueList args;
     args.append(engine->newQObject(rule));
     engine->setObjectOwnership(rule, QQmlEngine::CppOwnership);
+    args.append(engine->newQObject(event));
+    engine->setObjectOwnership(event, QQmlEngine::CppOwnership);
+    // The watchdog interrupts scripts running past their budget
+    quint64 token = ScriptWatchdog::instance()->arm(engine, RulePrivate::scriptBudget(rule));
     QJSValue returned = d->action.call(args);
+    if (ScriptWatchdog::instance()->disarm(token)) {
+        RulePrivate::scriptOverrun(rule);
+        return false;
+    }
     bool ok = true;
     if (returned.isBool()) {
         ok = returned.toBool();
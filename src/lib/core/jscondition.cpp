@@ -34,6 +34,9 @@
 #include <QtQml/QQmlContext>
 #include <QtQml/QQmlEngine>
 #include "rule.h"
+#include "rule_p.h"
+#include "scriptwatchdog.h"
+#include "triggerevent.h"
 
 class JsConditionPrivate: public ConditionPrivate
 {
@@ -69,7 +72,7 @@ void JsCondition::setCondition(const QJSValue &condition)
     }
 }
 
-bool JsCondition::isValid(Rule *rule)
+bool JsCondition::isValid(Rule *rule, TriggerEvent *event)
 {
     Q_D(JsCondition);
     if (!d->condition.isCallable()) {
@@ -85,7 +88,15 @@ bool JsCondition::isValid(Rule *rule)
     QJSValueList args;
     args.append(engine->newQObject(rule));
     engine->setObjectOwnership(rule, QQmlEngine::CppOwnership);
+    args.append(engine->newQObject(event));
+    engine->setObjectOwnership(event, QQmlEngine::CppOwnership);
+    // The watchdog interrupts scripts running past their budget
+    quint64 token = ScriptWatchdog::instance()->arm(engine, RulePrivate::scriptBudget(rule));
     QJSValue returned = d->condition.call(args);
+    if (ScriptWatchdog::instance()->disarm(token)) {
+        RulePrivate::scriptOverrun(rule);
+        return false;
+    }
     bool ok = false;
     if (returned.isBool()) {
         ok = returned.toBool();
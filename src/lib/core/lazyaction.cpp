@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "lazyaction.h"
+#include "action_p.h"
+#include "clocktimer.h"
+#include "phonebotlogging.h"
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+
+class LazyActionPrivate: public ActionPrivate
+{
+public:
+    explicit LazyActionPrivate(Action *q);
+    bool createAction();
+    void slotRelease();
+    QQmlComponent *component;
+    LazyAction::Creator creator;
+    int releaseInterval;
+    Action *action;
+    ClockTimer *releaseTimer;
+private:
+    Q_DECLARE_PUBLIC(LazyAction)
+};
+
+LazyActionPrivate::LazyActionPrivate(Action *q)
+    : ActionPrivate(q), component(0), releaseInterval(0), action(0), releaseTimer(0)
+{
+}
+
+bool LazyActionPrivate::createAction()
+{
+    Q_Q(LazyAction);
+    if (action) {
+        return true;
+    }
+
+    QObject *object = 0;
+    if (creator) {
+        object = creator();
+        if (!object) {
+            qCWarning(phonebotCore) << "LazyAction: failed to create the action";
+            return false;
+        }
+    } else {
+        if (!component) {
+            qCWarning(phonebotCore) << "LazyAction: no component to create the action from";
+            return false;
+        }
+
+        QQmlContext *context = QQmlEngine::contextForObject(q);
+        if (!context) {
+            context = component->creationContext();
+        }
+
+        object = component->create(context);
+        if (!object) {
+            qCWarning(phonebotCore) << "LazyAction: failed to create the action" << component->errorString();
+            return false;
+        }
+    }
+
+    action = qobject_cast<Action *>(object);
+    if (!action) {
+        qCWarning(phonebotCore) << "LazyAction: the component did not create an Action type";
+        delete object;
+        return false;
+    }
+
+    QQmlEngine::setObjectOwnership(action, QQmlEngine::CppOwnership);
+    action->setParent(q);
+    emit q->actionChanged();
+    return true;
+}
+
+void LazyActionPrivate::slotRelease()
+{
+    Q_Q(LazyAction);
+    if (action) {
+        action->deleteLater();
+        action = 0;
+        emit q->actionChanged();
+    }
+}
+
+LazyAction::LazyAction(QObject *parent) :
+    Action(*(new LazyActionPrivate(this)), parent)
+{
+}
+
+QQmlComponent * LazyAction::component() const
+{
+    Q_D(const LazyAction);
+    return d->component;
+}
+
+void LazyAction::setComponent(QQmlComponent *component)
+{
+    Q_D(LazyAction);
+    if (d->component != component) {
+        d->slotRelease();
+        d->component = component;
+        emit componentChanged();
+    }
+}
+
+void LazyAction::setCreator(const Creator &creator)
+{
+    Q_D(LazyAction);
+    d->slotRelease();
+    d->creator = creator;
+}
+
+int LazyAction::releaseInterval() const
+{
+    Q_D(const LazyAction);
+    return d->releaseInterval;
+}
+
+void LazyAction::setReleaseInterval(int releaseInterval)
+{
+    Q_D(LazyAction);
+    if (d->releaseInterval != releaseInterval) {
+        d->releaseInterval = releaseInterval;
+        emit releaseIntervalChanged();
+    }
+}
+
+Action * LazyAction::action() const
+{
+    Q_D(const LazyAction);
+    return d->action;
+}
+
+bool LazyAction::execute(Rule *rule, TriggerEvent *event)
+{
+    Q_D(LazyAction);
+    if (!d->createAction()) {
+        return false;
+    }
+
+    bool ok = true;
+    if (d->action->isEnabled()) {
+        ok = d->action->execute(rule, event);
+    }
+
+    // Release the action if it is not used for some time
+    if (d->releaseInterval > 0) {
+        if (!d->releaseTimer) {
+            d->releaseTimer = new ClockTimer(this);
+            d->releaseTimer->setSingleShot(true);
+            connect(d->releaseTimer, SIGNAL(timeout()), this, SLOT(slotRelease()));
+        }
+        d->releaseTimer->start(d->releaseInterval);
+    }
+    return ok;
+}
+
+#include "moc_lazyaction.cpp"
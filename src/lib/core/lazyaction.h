@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef LAZYACTION_H
+#define LAZYACTION_H
+
+#include "action.h"
+#include <functional>
+
+class QQmlComponent;
+class LazyActionPrivate;
+class LazyAction : public Action
+{
+    Q_OBJECT
+    Q_PROPERTY(QQmlComponent * component READ component WRITE setComponent NOTIFY componentChanged)
+    Q_PROPERTY(int releaseInterval READ releaseInterval WRITE setReleaseInterval
+               NOTIFY releaseIntervalChanged)
+    Q_PROPERTY(Action * action READ action NOTIFY actionChanged)
+    Q_CLASSINFO("DefaultProperty", "component")
+public:
+    typedef std::function<Action *()> Creator;
+    explicit LazyAction(QObject *parent = 0);
+    QQmlComponent * component() const;
+    void setComponent(QQmlComponent *component);
+    void setCreator(const Creator &creator);
+    int releaseInterval() const;
+    void setReleaseInterval(int releaseInterval);
+    Action * action() const;
+    bool execute(Rule *rule, TriggerEvent *event) override;
+Q_SIGNALS:
+    void componentChanged();
+    void releaseIntervalChanged();
+    void actionChanged();
+private:
+    Q_DECLARE_PRIVATE(LazyAction)
+    Q_PRIVATE_SLOT(d_func(), void slotRelease())
+};
+
+#endif // LAZYACTION_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QtCore/QtGlobal>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue with many producers and a single
+// consumer. Each cell carries a sequence number telling if it
+// is free for the producer at a position, or filled for the
+// consumer, so that pushing a value is a single CAS on the
+// enqueue position and never allocates.
+template<class T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(int capacity)
+        : m_capacity(roundedCapacity(capacity)), m_mask(m_capacity - 1)
+        , m_cells(new Cell[m_capacity]), m_enqueuePosition(0), m_dequeuePosition(0)
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    int capacity() const
+    {
+        return static_cast<int>(m_capacity);
+    }
+    // Can be called from any thread, returns false when the queue is full
+    bool push(const T &value)
+    {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Cell *cell = 0;
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            qintptr delta = static_cast<qintptr>(sequence) - static_cast<qintptr>(position);
+            if (delta == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (delta < 0) {
+                return false;
+            } else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    // Must only be called from the consumer thread
+    bool pop(T &value)
+    {
+        Cell *cell = &m_cells[m_dequeuePosition & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<qintptr>(sequence) - static_cast<qintptr>(m_dequeuePosition + 1) < 0) {
+            return false;
+        }
+
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(m_dequeuePosition + m_capacity, std::memory_order_release);
+        ++m_dequeuePosition;
+        return true;
+    }
+private:
+    Q_DISABLE_COPY(MpscQueue)
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    static size_t roundedCapacity(int capacity)
+    {
+        size_t rounded = 2;
+        while (rounded < static_cast<size_t>(qMax(capacity, 2))) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    // Producers and the consumer work on different cache lines
+    alignas(64) std::atomic<size_t> m_enqueuePosition;
+    alignas(64) size_t m_dequeuePosition;
+};
+
+#endif // MPSCQUEUE_H
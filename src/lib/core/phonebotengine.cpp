@@ -31,24 +31,77 @@
 
 #include "phonebotengine.h"
 #include "phonebotengine_p.h"
+#include "abstractrulefactory.h"
+#include <algorithm>
 #include <QtCore/QCoreApplication>
-#include <QtCore/QDebug>
+#include <QtCore/QMetaProperty>
 #include <QtCore/QPluginLoader>
 #include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtQml/qqml.h>
 #include "action.h"
 #include "jsaction.h"
 #include "condition.h"
 #include "jscondition.h"
+#include "lazyaction.h"
+#include "sequenceaction.h"
+#include "delayaction.h"
 #include "phonebotextensionplugin.h"
+#include "phonebotlogging.h"
 #include "rule.h"
+#include "ruledispatcher.h"
 #include "timemapper.h"
+#include "datetimemapper.h"
+#include "durationmapper.h"
+#include "daymaskmapper.h"
 #include "trigger.h"
+#include "triggerevent.h"
 
 static const char *REASON = "Cannot be created";
 
+RuleIncubator::RuleIncubator(PhoneBotEnginePrivate *engine, const QUrl &url)
+    : QQmlIncubator(QQmlIncubator::Asynchronous), m_engine(engine), m_url(url)
+{
+}
+
+QUrl RuleIncubator::url() const
+{
+    return m_url;
+}
+
+void RuleIncubator::statusChanged(Status status)
+{
+    m_engine->incubatorStatusChanged(this, status);
+}
+
+RuleIncubationController::RuleIncubationController()
+    : budget(0), m_timer(new QTimer())
+{
+    // Incubation is performed in slices, and other events
+    // are processed by the event loop between two slices
+    m_timer->setInterval(0);
+    QObject::connect(m_timer, &QTimer::timeout, [this]() {
+        incubateFor(budget);
+    });
+}
+
+RuleIncubationController::~RuleIncubationController()
+{
+    delete m_timer;
+}
+
+void RuleIncubationController::incubatingObjectCountChanged(int count)
+{
+    if (count > 0) {
+        m_timer->start();
+    } else {
+        m_timer->stop();
+    }
+}
+
 PhoneBotEnginePrivate::PhoneBotEnginePrivate(PhoneBotEngine *q)
-    : q_ptr(q)
+    : dispatcher(0), incubatedCount(0), incubationTotal(0), ready(false), q_ptr(q)
 {
 }
 
@@ -72,7 +125,7 @@ void PhoneBotEnginePrivate::manageComponentFinished(QQmlComponent *component)
     } else {
         if (component->isError()) {
             QString error = component->errorString();
-            qWarning() << error;
+            qCWarning(phonebotCore) << error;
             componentErrors.insert(url, error);
             component->deleteLater();
         }
@@ -83,7 +136,7 @@ void PhoneBotEnginePrivate::manageComponentFinished(QQmlComponent *component)
 void PhoneBotEnginePrivate::setRuleError(const QUrl &url, const QString &error)
 {
     ruleErrors.insert(url, error);
-    qWarning() << error;
+    qCWarning(phonebotCore) << error;
 }
 
 bool PhoneBotEnginePrivate::checkRule(Rule *rule)
@@ -101,6 +154,220 @@ bool PhoneBotEnginePrivate::checkRule(Rule *rule)
     return true;
 }
 
+Rule * PhoneBotEnginePrivate::createRule(QQmlComponent *component)
+{
+    return registerRule(component->url(), component->create());
+}
+
+Rule * PhoneBotEnginePrivate::createRule(const QUrl &url, AbstractRuleFactory *factory)
+{
+    Rule *rule = factory->create();
+    if (!rule) {
+        setRuleError(url, QString("Rule cannot be created natively. %1").arg(factory->errorString()));
+        return nullptr;
+    }
+    return registerRule(url, rule);
+}
+
+Rule * PhoneBotEnginePrivate::registerRule(const QUrl &url, QObject *ruleObject)
+{
+    Q_Q(PhoneBotEngine);
+    if (!ruleObject) {
+        setRuleError(url, "Rule cannot be created from component.");
+        return nullptr;
+    }
+
+    Rule *rule = qobject_cast<Rule *>(ruleObject);
+    if (!rule) {
+        setRuleError(url, "The component did not create a Rule type.");
+        return nullptr;
+    }
+
+    if (!checkRule(rule)) {
+        ruleObject->deleteLater();
+        setRuleError(url, "Invalid Rule created. Check if trigger and actions are set.");
+        return nullptr;
+    }
+
+    if (rules.contains(url)) {
+        deleteRule(rules.value(url));
+    }
+    rules.insert(url, rule);
+    rule->setSource(url);
+    rule->setDispatcher(dispatcher);
+    hibernatedRules.remove(url);
+    QObject::connect(rule, &Rule::enabledChanged, q, [this, url]() {
+        scheduleHibernation(url);
+    });
+    QObject::connect(rule, &Rule::scriptBudgetExhausted, q, [this, url, rule]() {
+        setRuleError(url, QString("Rule disabled after %1 scripts exceeded their budget of %2 ms.")
+                     .arg(rule->scriptOverrunCount()).arg(rule->scriptBudget()));
+    });
+    emit q->ruleCreated(url);
+
+    if (!rule->isEnabled()) {
+        scheduleHibernation(url);
+    }
+    return rule;
+}
+
+void PhoneBotEnginePrivate::incubatorStatusChanged(RuleIncubator *incubator,
+                                                   QQmlIncubator::Status status)
+{
+    Q_Q(PhoneBotEngine);
+    QUrl url = incubator->url();
+    if (status == QQmlIncubator::Ready) {
+        registerRule(url, incubator->object());
+    } else if (status == QQmlIncubator::Error) {
+        QStringList errors;
+        for (const QQmlError &error : incubator->errors()) {
+            errors.append(error.toString());
+        }
+        setRuleError(url, QString("Rule cannot be created from component. %1").arg(errors.join(" ")));
+    } else {
+        return;
+    }
+
+    // The incubator cannot be deleted from its own callback
+    incubators.remove(url);
+    finishedIncubators.append(incubator);
+    QCoreApplication::instance()->postEvent(q, new QEvent(QEvent::User));
+    finishIncubation();
+}
+
+// Called once an incubator is done with, either because
+// its rule was created, or because it was removed
+void PhoneBotEnginePrivate::finishIncubation()
+{
+    Q_Q(PhoneBotEngine);
+    ++incubatedCount;
+    emit q->startProgress(incubatedCount, incubationTotal);
+    if (incubators.isEmpty()) {
+        setReady(true);
+    }
+}
+
+void PhoneBotEnginePrivate::cancelIncubators()
+{
+    QList<RuleIncubator *> pending = incubators.values();
+    incubators.clear();
+    for (RuleIncubator *incubator : pending) {
+        incubator->clear();
+        delete incubator;
+    }
+    deleteFinishedIncubators();
+}
+
+void PhoneBotEnginePrivate::deleteFinishedIncubators()
+{
+    qDeleteAll(finishedIncubators);
+    finishedIncubators.clear();
+}
+
+void PhoneBotEnginePrivate::saveNextTriggerHint(const QUrl &url, Rule *rule)
+{
+    if (rule->trigger()) {
+        QDateTime next = rule->trigger()->nextTriggerTime();
+        if (next.isValid()) {
+            nextTriggerHints.insert(url, next);
+        }
+    }
+}
+
+void PhoneBotEnginePrivate::scheduleHibernation(const QUrl &url)
+{
+    Q_Q(PhoneBotEngine);
+    // Disabled rules are hibernated later, as the rule
+    // might have been disabled by one of its own actions
+    Rule *rule = rules.value(url, nullptr);
+    if (rule && !rule->isEnabled() && !pendingHibernations.contains(url)) {
+        pendingHibernations.insert(url);
+        QCoreApplication::instance()->postEvent(q, new QEvent(QEvent::User));
+    }
+}
+
+void PhoneBotEnginePrivate::hibernatePendingRules()
+{
+    QSet<QUrl> urls = pendingHibernations;
+    pendingHibernations.clear();
+    for (const QUrl &url : urls) {
+        hibernate(url);
+    }
+}
+
+void PhoneBotEnginePrivate::hibernate(const QUrl &url)
+{
+    Rule *rule = rules.value(url, nullptr);
+    if (!rule || rule->isEnabled()) {
+        return;
+    }
+
+    // Only the component and the values of the simple properties
+    // of the rule are kept, so that the trigger, the condition and the
+    // actions stop consuming resources while the rule is disabled
+    QVariantMap snapshot;
+    const QMetaObject *meta = rule->metaObject();
+    for (int i = 0; i < meta->propertyCount(); ++i) {
+        QMetaProperty property = meta->property(i);
+        if (!property.isWritable() || !property.isStored()) {
+            continue;
+        }
+
+        int type = property.userType();
+        if (QMetaType::typeFlags(type) & QMetaType::PointerToQObject
+            || QByteArray(property.typeName()).startsWith("QQmlListProperty")) {
+            continue;
+        }
+        snapshot.insert(property.name(), property.read(rule));
+    }
+
+    saveNextTriggerHint(url, rule);
+    rules.remove(url);
+    hibernatedRules.insert(url, snapshot);
+    destroyRule(rule);
+}
+
+Rule * PhoneBotEnginePrivate::rehydrate(const QUrl &url)
+{
+    Q_Q(PhoneBotEngine);
+    QQmlComponent *component = components.value(url, nullptr);
+    AbstractRuleFactory *factory = factories.value(url, nullptr);
+    if ((!component && !factory) || !hibernatedRules.contains(url)) {
+        return nullptr;
+    }
+
+    QVariantMap snapshot = hibernatedRules.take(url);
+    QObject *ruleObject = nullptr;
+    if (component) {
+        ruleObject = component->beginCreate(q->rootContext());
+    } else {
+        ruleObject = factory->create();
+    }
+
+    // The snapshot is applied once the rule is fully constructed, on
+    // both paths, so it is not overwritten by the creation. The values
+    // of bound properties are replaced by the saved literal values.
+    if (ruleObject) {
+        if (component) {
+            component->completeCreate();
+        }
+        for (QVariantMap::const_iterator it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+            ruleObject->setProperty(it.key().toLatin1().constData(), it.value());
+        }
+        ruleObject->setProperty("enabled", true);
+    }
+    return registerRule(url, ruleObject);
+}
+
+void PhoneBotEnginePrivate::setReady(bool newReady)
+{
+    Q_Q(PhoneBotEngine);
+    if (ready != newReady) {
+        ready = newReady;
+        emit q->readyChanged();
+    }
+}
+
 void PhoneBotEnginePrivate::deleteRule(Rule *rule)
 {
     if (QQmlEngine::objectOwnership(rule) == QQmlEngine::CppOwnership) {
@@ -108,6 +375,13 @@ void PhoneBotEnginePrivate::deleteRule(Rule *rule)
     }
 }
 
+void PhoneBotEnginePrivate::destroyRule(Rule *rule)
+{
+    if (QQmlEngine::objectOwnership(rule) == QQmlEngine::CppOwnership) {
+        delete rule;
+    }
+}
+
 PhoneBotEngine::PhoneBotEngine(QObject *parent)
     : QQmlEngine(parent), d_ptr(new PhoneBotEnginePrivate(this))
 {
@@ -115,9 +389,17 @@ PhoneBotEngine::PhoneBotEngine(QObject *parent)
 
 PhoneBotEngine::~PhoneBotEngine()
 {
+    Q_D(PhoneBotEngine);
     stop();
+    qDeleteAll(d->factories);
+}
 
-    // Delete static plugins (Qt do not perform this cleanup)
+// Qt do not perform this cleanup. Plugins are shared by every engine,
+// including the ones living in worker threads, so this should only be
+// called from the main thread once every engine is destroyed
+void PhoneBotEngine::deleteStaticPlugins()
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
     QObjectList staticPlugins = QPluginLoader::staticInstances();
     for (QObject *plugin : staticPlugins) {
         delete plugin;
@@ -127,13 +409,20 @@ PhoneBotEngine::~PhoneBotEngine()
 void PhoneBotEngine::registerTypes()
 {
     qmlRegisterType<Trigger>("org.SfietKonstantin.phonebot", 1, 0, "Trigger");
+    qmlRegisterUncreatableType<TriggerEvent>("org.SfietKonstantin.phonebot", 1, 0, "TriggerEvent", REASON);
     qmlRegisterUncreatableType<Condition>("org.SfietKonstantin.phonebot", 1, 0, "ConditionBase", REASON);
     qmlRegisterType<JsCondition>("org.SfietKonstantin.phonebot", 1, 0, "Condition");
     qmlRegisterUncreatableType<Action>("org.SfietKonstantin.phonebot", 1, 0, "ActionBase", REASON);
     qmlRegisterType<JsAction>("org.SfietKonstantin.phonebot", 1, 0, "Action");
+    qmlRegisterType<LazyAction>("org.SfietKonstantin.phonebot", 1, 0, "LazyAction");
+    qmlRegisterType<SequenceAction>("org.SfietKonstantin.phonebot", 1, 0, "SequenceAction");
+    qmlRegisterType<DelayAction>("org.SfietKonstantin.phonebot", 1, 0, "DelayAction");
     qmlRegisterType<Rule>("org.SfietKonstantin.phonebot", 1, 0, "Rule");
     qmlRegisterUncreatableType<AbstractMapper>("org.SfietKonstantin.phonebot", 1, 0, "Mapper", REASON);
     qmlRegisterType<TimeMapper>("org.SfietKonstantin.phonebot", 1, 0, "TimeMapper");
+    qmlRegisterType<DateTimeMapper>("org.SfietKonstantin.phonebot", 1, 0, "DateTimeMapper");
+    qmlRegisterType<DurationMapper>("org.SfietKonstantin.phonebot", 1, 0, "DurationMapper");
+    qmlRegisterType<DayMaskMapper>("org.SfietKonstantin.phonebot", 1, 0, "DayMaskMapper");
 
     // Register static plugin paths
     QObjectList staticPlugins = QPluginLoader::staticInstances();
@@ -151,7 +440,8 @@ void PhoneBotEngine::registerTypes()
 bool PhoneBotEngine::addComponent(const QUrl &url)
 {
     Q_D(PhoneBotEngine);
-    if (d->components.contains(url) || d->componentErrors.contains(url)) {
+    if (d->components.contains(url) || d->componentErrors.contains(url)
+        || d->factories.contains(url)) {
         return false;
     }
     QQmlComponent *component = new QQmlComponent(this, url, QQmlComponent::Asynchronous, this);
@@ -165,6 +455,29 @@ bool PhoneBotEngine::addComponent(const QUrl &url)
     return true;
 }
 
+bool PhoneBotEngine::addFactory(const QUrl &url, AbstractRuleFactory *factory)
+{
+    Q_D(PhoneBotEngine);
+    if (d->components.contains(url) || d->componentErrors.contains(url)
+        || d->factories.contains(url)) {
+        delete factory;
+        return false;
+    }
+
+    // Factories are ready immediately, but loading is
+    // still notified asynchronously, like for components
+    d->factories.insert(url, factory);
+    d->loadedFactories.append(url);
+    QCoreApplication::instance()->postEvent(this, new QEvent(QEvent::User));
+    return true;
+}
+
+bool PhoneBotEngine::hasFactory(const QUrl &url) const
+{
+    Q_D(const PhoneBotEngine);
+    return d->factories.contains(url);
+}
+
 QQmlComponent * PhoneBotEngine::component(const QUrl &url) const
 {
     Q_D(const PhoneBotEngine);
@@ -189,46 +502,276 @@ QString PhoneBotEngine::ruleError(const QUrl &url)const
     return d->ruleErrors.value(url, QString());
 }
 
-void PhoneBotEngine::start()
+bool PhoneBotEngine::removeComponent(const QUrl &url)
+{
+    Q_D(PhoneBotEngine);
+    bool removed = false;
+    if (d->incubators.contains(url)) {
+        RuleIncubator *incubator = d->incubators.take(url);
+        incubator->clear();
+        delete incubator;
+        d->finishIncubation();
+    }
+
+    if (d->rules.contains(url)) {
+        Rule *rule = d->rules.take(url);
+        d->saveNextTriggerHint(url, rule);
+        PhoneBotEnginePrivate::destroyRule(rule);
+    }
+    d->hibernatedRules.remove(url);
+    d->pendingHibernations.remove(url);
+    d->ruleErrors.remove(url);
+
+    if (d->components.contains(url)) {
+        delete d->components.take(url);
+        removed = true;
+    }
+
+    if (d->factories.contains(url)) {
+        delete d->factories.take(url);
+        d->loadedFactories.removeAll(url);
+        removed = true;
+    }
+
+    for (int i = d->loadedComponents.count() - 1; i >= 0; --i) {
+        QQmlComponent *component = d->loadedComponents.at(i);
+        if (component->url() == url) {
+            d->loadedComponents.removeAt(i);
+            delete component;
+            removed = true;
+        }
+    }
+
+    if (d->componentErrors.remove(url) > 0) {
+        removed = true;
+    }
+
+    // Drop the cached compiled data, so that the next
+    // time this url is added, the file is parsed again
+    trimComponentCache();
+    return removed;
+}
+
+void PhoneBotEngine::clear()
 {
     Q_D(PhoneBotEngine);
+    d->cancelIncubators();
+    d->setReady(false);
     d->ruleErrors.clear();
-    for (QQmlComponent *component : d->components) {
-        QUrl url = component->url();
-        QObject *ruleObject = component->create();
-        if (!ruleObject) {
-            d->setRuleError(url, "Rule cannot be created from component.");
-            continue;
+    for (QMap<QUrl, Rule *>::const_iterator it = d->rules.constBegin(); it != d->rules.constEnd(); ++it) {
+        d->saveNextTriggerHint(it.key(), it.value());
+        PhoneBotEnginePrivate::destroyRule(it.value());
+    }
+    d->rules.clear();
+    d->hibernatedRules.clear();
+    d->pendingHibernations.clear();
+
+    qDeleteAll(d->components);
+    d->components.clear();
+    qDeleteAll(d->factories);
+    d->factories.clear();
+    d->loadedFactories.clear();
+    qDeleteAll(d->loadedComponents);
+    d->loadedComponents.clear();
+    d->componentErrors.clear();
+    trimComponentCache();
+}
+
+bool PhoneBotEngine::startComponent(const QUrl &url)
+{
+    Q_D(PhoneBotEngine);
+    d->ruleErrors.remove(url);
+    if (d->factories.contains(url)) {
+        return d->createRule(url, d->factories.value(url)) != nullptr;
+    }
+
+    QQmlComponent *component = d->components.value(url, nullptr);
+    if (!component) {
+        return false;
+    }
+    return d->createRule(component) != nullptr;
+}
+
+int PhoneBotEngine::incubationBudget() const
+{
+    Q_D(const PhoneBotEngine);
+    return d->incubationController ? d->incubationController->budget : 0;
+}
+
+void PhoneBotEngine::setIncubationBudget(int incubationBudget)
+{
+    Q_D(PhoneBotEngine);
+    if (incubationBudget <= 0) {
+        if (d->incubationController) {
+            d->cancelIncubators();
+            setIncubationController(0);
+            d->incubationController.reset();
         }
+        return;
+    }
 
-        Rule *rule = qobject_cast<Rule *>(ruleObject);
-        if (!rule) {
-            d->setRuleError(url, "The component did not create a Rule type.");
-            continue;
+    if (!d->incubationController) {
+        d->incubationController.reset(new RuleIncubationController());
+        setIncubationController(d->incubationController.data());
+    }
+    d->incubationController->budget = incubationBudget;
+}
+
+QDateTime PhoneBotEngine::nextTriggerHint(const QUrl &url) const
+{
+    Q_D(const PhoneBotEngine);
+    Rule *rule = d->rules.value(url, nullptr);
+    if (rule && rule->trigger()) {
+        QDateTime next = rule->trigger()->nextTriggerTime();
+        if (next.isValid()) {
+            return next;
         }
+    }
+    return d->nextTriggerHints.value(url);
+}
 
-        if (!PhoneBotEnginePrivate::checkRule(qobject_cast<Rule *>(rule))) {
-            ruleObject->deleteLater();
-            d->setRuleError(url, "Invalid Rule created. Check if trigger and actions are set.");
-            continue;
+void PhoneBotEngine::setNextTriggerHint(const QUrl &url, const QDateTime &nextTriggerHint)
+{
+    Q_D(PhoneBotEngine);
+    if (nextTriggerHint.isValid()) {
+        d->nextTriggerHints.insert(url, nextTriggerHint);
+    } else {
+        d->nextTriggerHints.remove(url);
+    }
+}
+
+bool PhoneBotEngine::isHibernated(const QUrl &url) const
+{
+    Q_D(const PhoneBotEngine);
+    return d->hibernatedRules.contains(url);
+}
+
+bool PhoneBotEngine::setRuleEnabled(const QUrl &url, bool enabled)
+{
+    Q_D(PhoneBotEngine);
+    // Re-enabling a rule gives it a new chance
+    if (enabled) {
+        d->ruleErrors.remove(url);
+    }
+
+    Rule *rule = d->rules.value(url, nullptr);
+    if (rule) {
+        rule->setEnabled(enabled);
+        return true;
+    }
+
+    if (!d->hibernatedRules.contains(url)) {
+        return false;
+    }
+
+    if (!enabled) {
+        return true;
+    }
+    return d->rehydrate(url) != nullptr;
+}
+
+bool PhoneBotEngine::isReady() const
+{
+    Q_D(const PhoneBotEngine);
+    return d->ready;
+}
+
+bool PhoneBotEngine::isDispatchEnabled() const
+{
+    Q_D(const PhoneBotEngine);
+    return d->dispatcher != nullptr;
+}
+
+void PhoneBotEngine::setDispatchEnabled(bool dispatchEnabled)
+{
+    Q_D(PhoneBotEngine);
+    if (isDispatchEnabled() == dispatchEnabled) {
+        return;
+    }
+
+    // Rules are executed in priority order through the dispatcher
+    // instead of directly when their trigger fires
+    RuleDispatcher *dispatcher = d->dispatcher;
+    d->dispatcher = dispatchEnabled ? new RuleDispatcher(this) : nullptr;
+    for (Rule *rule : d->rules) {
+        rule->setDispatcher(d->dispatcher);
+    }
+    delete dispatcher;
+}
+
+RuleDispatcher * PhoneBotEngine::dispatcher() const
+{
+    Q_D(const PhoneBotEngine);
+    return d->dispatcher;
+}
+
+void PhoneBotEngine::start()
+{
+    Q_D(PhoneBotEngine);
+    d->ruleErrors.clear();
+    d->cancelIncubators();
+    d->setReady(false);
+
+    // Rules built natively are cheap to create
+    for (QMap<QUrl, AbstractRuleFactory *>::const_iterator it = d->factories.constBegin();
+         it != d->factories.constEnd(); ++it) {
+        d->createRule(it.key(), it.value());
+    }
+
+    // Progress covers native rules, that are already created
+    int total = d->factories.count() + d->components.count();
+    if (!d->incubationController) {
+        for (QQmlComponent *component : d->components) {
+            d->createRule(component);
         }
+        emit startProgress(total, total);
+        d->setReady(true);
+        return;
+    }
 
-        if (d->rules.contains(url)) {
-            PhoneBotEnginePrivate::deleteRule(d->rules.value(url));
+    // Rules that are going to be triggered soon are
+    // incubated first. Rules without hints come last.
+    QList<QQmlComponent *> components = d->components.values();
+    const QMap<QUrl, QDateTime> &hints = d->nextTriggerHints;
+    std::stable_sort(components.begin(), components.end(),
+                     [&hints](QQmlComponent *first, QQmlComponent *second) {
+        QDateTime firstHint = hints.value(first->url());
+        QDateTime secondHint = hints.value(second->url());
+        if (firstHint.isValid() != secondHint.isValid()) {
+            return firstHint.isValid();
         }
-        d->rules.insert(component->url(), rule);
+        return firstHint < secondHint;
+    });
+
+    d->incubatedCount = d->factories.count();
+    d->incubationTotal = total;
+    if (components.isEmpty()) {
+        emit startProgress(total, total);
+        d->setReady(true);
+        return;
+    }
+
+    for (QQmlComponent *component : components) {
+        RuleIncubator *incubator = new RuleIncubator(d, component->url());
+        d->incubators.insert(component->url(), incubator);
+        component->create(*incubator);
     }
 }
 
 void PhoneBotEngine::stop()
 {
     Q_D(PhoneBotEngine);
+    d->cancelIncubators();
+    d->setReady(false);
     d->ruleErrors.clear();
 
-    for (Rule *rule : d->rules) {
-        PhoneBotEnginePrivate::deleteRule(rule);
+    for (QMap<QUrl, Rule *>::const_iterator it = d->rules.constBegin(); it != d->rules.constEnd(); ++it) {
+        d->saveNextTriggerHint(it.key(), it.value());
+        PhoneBotEnginePrivate::deleteRule(it.value());
     }
     d->rules.clear();
+    d->hibernatedRules.clear();
+    d->pendingHibernations.clear();
 }
 
 bool PhoneBotEngine::event(QEvent *e)
@@ -236,10 +779,18 @@ bool PhoneBotEngine::event(QEvent *e)
     Q_D(PhoneBotEngine);
     if (e->type() == QEvent::User) {
         e->accept();
-        for (QQmlComponent *component : d->loadedComponents) {
+        QList<QQmlComponent *> loadedComponents = d->loadedComponents;
+        d->loadedComponents.clear();
+        for (QQmlComponent *component : loadedComponents) {
             d->manageComponentFinished(component);
         }
-        d->loadedComponents.clear();
+        QList<QUrl> loadedFactories = d->loadedFactories;
+        d->loadedFactories.clear();
+        for (const QUrl &url : loadedFactories) {
+            emit componentLoadingFinished(url, true);
+        }
+        d->deleteFinishedIncubators();
+        d->hibernatePendingRules();
         return true;
     }
 
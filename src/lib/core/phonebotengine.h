@@ -32,9 +32,12 @@
 #ifndef PHONEBOTENGINE_H
 #define PHONEBOTENGINE_H
 
+#include <QtCore/QDateTime>
 #include <QtQml/QQmlEngine>
 
+class AbstractRuleFactory;
 class Rule;
+class RuleDispatcher;
 class PhoneBotEnginePrivate;
 class PhoneBotEngine: public QQmlEngine
 {
@@ -43,16 +46,35 @@ public:
     explicit PhoneBotEngine(QObject *parent = 0);
     virtual ~PhoneBotEngine();
     static void registerTypes();
+    static void deleteStaticPlugins();
     bool addComponent(const QUrl &url);
+    bool addFactory(const QUrl &url, AbstractRuleFactory *factory);
+    bool hasFactory(const QUrl &url) const;
+    bool removeComponent(const QUrl &url);
+    void clear();
     QQmlComponent * component(const QUrl &url) const;
     QString componentError(const QUrl &url) const;
     Rule * rule(const QUrl &url) const;
     QString ruleError(const QUrl &url) const;
+    bool isHibernated(const QUrl &url) const;
+    bool setRuleEnabled(const QUrl &url, bool enabled);
+    int incubationBudget() const;
+    void setIncubationBudget(int incubationBudget);
+    QDateTime nextTriggerHint(const QUrl &url) const;
+    void setNextTriggerHint(const QUrl &url, const QDateTime &nextTriggerHint);
+    bool isReady() const;
+    bool isDispatchEnabled() const;
+    void setDispatchEnabled(bool dispatchEnabled);
+    RuleDispatcher * dispatcher() const;
 public:
     void start();
+    bool startComponent(const QUrl &url);
     void stop();
 Q_SIGNALS:
     void componentLoadingFinished(const QUrl &url, bool ok);
+    void ruleCreated(const QUrl &url);
+    void startProgress(int created, int total);
+    void readyChanged();
 protected:
     bool event(QEvent *e);
     QScopedPointer<PhoneBotEnginePrivate> d_ptr;
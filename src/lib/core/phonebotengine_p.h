@@ -33,7 +33,38 @@
 #define PHONEBOTENGINE_P_H
 
 #include "phonebotengine.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QSet>
 #include <QtQml/QQmlComponent>
+#include <QtQml/QQmlIncubator>
+
+class QTimer;
+class AbstractRuleFactory;
+class RuleDispatcher;
+class PhoneBotEnginePrivate;
+class RuleIncubator: public QQmlIncubator
+{
+public:
+    explicit RuleIncubator(PhoneBotEnginePrivate *engine, const QUrl &url);
+    QUrl url() const;
+protected:
+    void statusChanged(Status status) override;
+private:
+    PhoneBotEnginePrivate *m_engine;
+    QUrl m_url;
+};
+
+class RuleIncubationController: public QQmlIncubationController
+{
+public:
+    explicit RuleIncubationController();
+    virtual ~RuleIncubationController();
+    int budget;
+protected:
+    void incubatingObjectCountChanged(int count) override;
+private:
+    QTimer *m_timer;
+};
 
 class PhoneBotEnginePrivate
 {
@@ -42,13 +73,39 @@ public:
     void slotComponentFinished(QQmlComponent::Status status);
     void manageComponentFinished(QQmlComponent *component);
     void setRuleError(const QUrl &url, const QString &error);
+    Rule * createRule(QQmlComponent *component);
+    Rule * createRule(const QUrl &url, AbstractRuleFactory *factory);
+    Rule * registerRule(const QUrl &url, QObject *ruleObject);
+    void incubatorStatusChanged(RuleIncubator *incubator, QQmlIncubator::Status status);
+    void finishIncubation();
+    void cancelIncubators();
+    void deleteFinishedIncubators();
+    void saveNextTriggerHint(const QUrl &url, Rule *rule);
+    void setReady(bool ready);
+    void scheduleHibernation(const QUrl &url);
+    void hibernatePendingRules();
+    void hibernate(const QUrl &url);
+    Rule * rehydrate(const QUrl &url);
     static bool checkRule(Rule *rule);
     static void deleteRule(Rule *rule);
+    static void destroyRule(Rule *rule);
     QList<QQmlComponent *> loadedComponents;
     QMap<QUrl, QQmlComponent *> components;
+    QMap<QUrl, AbstractRuleFactory *> factories;
+    QList<QUrl> loadedFactories;
     QMap<QUrl, QString> componentErrors;
     QMap<QUrl, Rule *> rules;
     QMap<QUrl, QString> ruleErrors;
+    QMap<QUrl, QDateTime> nextTriggerHints;
+    QMap<QUrl, QVariantMap> hibernatedRules;
+    QSet<QUrl> pendingHibernations;
+    QMap<QUrl, RuleIncubator *> incubators;
+    QList<RuleIncubator *> finishedIncubators;
+    QScopedPointer<RuleIncubationController> incubationController;
+    RuleDispatcher *dispatcher;
+    int incubatedCount;
+    int incubationTotal;
+    bool ready;
 protected:
     PhoneBotEngine * const q_ptr;
 private:
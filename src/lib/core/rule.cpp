@@ -32,11 +32,107 @@
 #include "rule.h"
 #include "rule_p.h"
 #include "action.h"
+#include "clock.h"
+#include "clocktimer.h"
 #include "condition.h"
+#include "executionjournal.h"
+#include "executionjournalformat.h"
+#include "ruledispatcher.h"
+#include "sequenceaction.h"
 #include "trigger.h"
+#include "triggerevent.h"
+#include "triggerrecorder.h"
+#include <QtCore/QMultiMap>
+#include <QtCore/QThreadStorage>
+
+// Rules living in the same thread share a single
+// timer for their debounce deadlines
+class RuleTimer
+{
+public:
+    explicit RuleTimer();
+    qint64 now() const;
+    void schedule(RulePrivate *rule, qint64 deadline);
+    void cancel(RulePrivate *rule);
+private:
+    void process();
+    void restart();
+    ClockTimer timer;
+    QMultiMap<qint64, RulePrivate *> deadlines;
+};
+
+static const int DEFAULT_SCRIPT_BUDGET = 1000; // 1 sec in msecs
+static const int DEFAULT_MAX_SCRIPT_OVERRUNS = 3;
+
+static QThreadStorage<RuleTimer *> ruleTimers;
+
+static RuleTimer * ruleTimer()
+{
+    if (!ruleTimers.hasLocalData()) {
+        ruleTimers.setLocalData(new RuleTimer());
+    }
+    return ruleTimers.localData();
+}
+
+RuleTimer::RuleTimer()
+{
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &ClockTimer::timeout, [this]() {
+        process();
+    });
+}
+
+qint64 RuleTimer::now() const
+{
+    return Clock::instance()->elapsed();
+}
+
+void RuleTimer::schedule(RulePrivate *rule, qint64 deadline)
+{
+    cancel(rule);
+    deadlines.insert(deadline, rule);
+    restart();
+}
+
+void RuleTimer::cancel(RulePrivate *rule)
+{
+    QMultiMap<qint64, RulePrivate *>::iterator i = deadlines.begin();
+    while (i != deadlines.end()) {
+        if (i.value() == rule) {
+            i = deadlines.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void RuleTimer::process()
+{
+    qint64 current = now();
+    while (!deadlines.isEmpty() && deadlines.firstKey() <= current) {
+        RulePrivate *rule = deadlines.first();
+        deadlines.erase(deadlines.begin());
+        rule->slotDebounceTimeout();
+    }
+    restart();
+}
+
+void RuleTimer::restart()
+{
+    if (deadlines.isEmpty()) {
+        timer.stop();
+        return;
+    }
+    timer.start(static_cast<int>(qMax<qint64>(0, deadlines.firstKey() - now())));
+}
 
 RulePrivate::RulePrivate(Rule *q)
-    : enabled(true), trigger(nullptr), condition(nullptr), q_ptr(q)
+    : enabled(true), trigger(nullptr), condition(nullptr), debounce(0)
+    , debounceMode(Rule::Trailing), minimumInterval(0), maxExecutions(0), executionWindow(0)
+    , hysteresis(0), priority(0), scriptBudget(DEFAULT_SCRIPT_BUDGET)
+    , maxScriptOverruns(DEFAULT_MAX_SCRIPT_OVERRUNS), scriptOverrunCount(0), droppedCount(0)
+    , coalescedCount(0), journalId(0), lastTrigger(-1), lastExecution(-1)
+    , validStreak(0), pending(false), q_ptr(q)
 {
 }
 
@@ -102,30 +198,193 @@ int RulePrivate::mappers_count(QQmlListProperty<AbstractMapper> *list)
     return rule->d_func()->mappers.count();
 }
 
-void RulePrivate::slotTriggered()
+void RulePrivate::slotTriggered(TriggerEvent *event)
 {
-    Q_Q(Rule);
     Q_ASSERT(trigger != nullptr);
+    // Events are traced before any filtering, so that
+    // they can be replayed against other rule sets
+    TriggerRecorder *recorder = TriggerRecorder::instance();
+    if (recorder) {
+        recorder->record(source.toString(), event);
+    }
+
     if (!enabled) {
         return;
     }
 
+    ExecutionJournal *journal = ExecutionJournal::instance();
+    if (journal) {
+        journal->record(JournalTriggerFired, journalId, 0, true, journal->now());
+    }
+
+    if (debounce > 0) {
+        qint64 now = ruleTimer()->now();
+        bool inWindow = lastTrigger != -1 && now - lastTrigger < debounce;
+        lastTrigger = now;
+        if (debounceMode == Rule::Leading) {
+            // Only the first event of a burst runs. Each
+            // event of the burst extends the window.
+            if (inWindow) {
+                coalesce();
+                return;
+            }
+        } else {
+            // Only the last event of a burst runs, once the
+            // trigger has been quiet for the debounce duration
+            if (pending) {
+                coalesce();
+            }
+            pending = true;
+            pendingTimestamp = event ? event->timestamp() : Clock::instance()->currentDateTime();
+            pendingPayload = event ? event->payload() : QVariantMap();
+            ruleTimer()->schedule(this, now + debounce);
+            return;
+        }
+    }
+
+    run(event);
+}
+
+void RulePrivate::slotDebounceTimeout()
+{
+    if (!pending) {
+        return;
+    }
+
+    pending = false;
+    TriggerEvent event (trigger, pendingTimestamp, pendingPayload);
+    pendingPayload.clear();
+    if (enabled && trigger != nullptr) {
+        run(&event);
+    }
+}
+
+void RulePrivate::run(TriggerEvent *event)
+{
+    Q_Q(Rule);
+    // With a dispatcher, the rule is executed when its turn comes
+    if (dispatcher) {
+        dispatcher->enqueue(q, event);
+        return;
+    }
+    execute(event);
+}
+
+void RulePrivate::dispatch(Rule *rule, TriggerEvent *event)
+{
+    RulePrivate *d = rule->d_func();
+    if (d->enabled) {
+        d->execute(event);
+    }
+}
+
+void RulePrivate::execute(TriggerEvent *event)
+{
+    Q_Q(Rule);
+    qint64 now = ruleTimer()->now();
+    if (minimumInterval > 0 && lastExecution != -1 && now - lastExecution < minimumInterval) {
+        drop();
+        return;
+    }
+
+    bool rateLimited = maxExecutions > 0 && executionWindow > 0;
+    if (rateLimited) {
+        while (!executions.isEmpty() && now - executions.head() >= executionWindow) {
+            executions.dequeue();
+        }
+        if (executions.count() >= maxExecutions) {
+            drop();
+            return;
+        }
+    }
+
+    ExecutionJournal *journal = ExecutionJournal::instance();
     bool ok = true;
     if (condition != nullptr) {
         if (condition->isEnabled()) {
-            ok = condition->isValid(q);
+            qint64 start = journal ? journal->now() : 0;
+            ok = condition->isValid(q, event);
+            if (journal) {
+                journal->record(JournalConditionChecked, journalId, 0, ok, start);
+            }
         }
     }
 
+    // The condition has to hold for several consecutive
+    // firings before the actions are run
+    if (hysteresis > 1) {
+        validStreak = ok ? validStreak + 1 : 0;
+        ok = validStreak >= hysteresis;
+    }
+
     if (ok) {
-        for (Action *action : actions) {
+        lastExecution = now;
+        if (rateLimited) {
+            executions.enqueue(now);
+        }
+        for (int i = 0; i < actions.count(); ++i) {
+            // The rule might have been disabled by the watchdog
+            if (!enabled) {
+                break;
+            }
+
+            Action *action = actions.at(i);
             if (action->isEnabled()) {
-                action->execute(q);
+                qint64 start = journal ? journal->now() : 0;
+                bool executed = action->execute(q, event);
+                if (journal) {
+                    journal->record(JournalActionExecuted, journalId, i, executed, start);
+                }
             }
         }
     }
 }
 
+int RulePrivate::scriptBudget(Rule *rule)
+{
+    return rule ? rule->d_func()->scriptBudget : DEFAULT_SCRIPT_BUDGET;
+}
+
+void RulePrivate::scriptOverrun(Rule *rule)
+{
+    if (!rule) {
+        return;
+    }
+
+    // A rule whose scripts keep on exceeding their
+    // budget is disabled, to bound the latency of others
+    RulePrivate *d = rule->d_func();
+    ++d->scriptOverrunCount;
+    emit rule->scriptOverrunCountChanged();
+    if (d->maxScriptOverruns > 0 && d->scriptOverrunCount >= d->maxScriptOverruns && d->enabled) {
+        rule->setEnabled(false);
+        emit rule->scriptBudgetExhausted();
+    }
+}
+
+void RulePrivate::drop()
+{
+    Q_Q(Rule);
+    ++droppedCount;
+    emit q->droppedCountChanged();
+}
+
+void RulePrivate::coalesce()
+{
+    Q_Q(Rule);
+    ++coalescedCount;
+    emit q->coalescedCountChanged();
+}
+
+void RulePrivate::cancelPending()
+{
+    if (pending) {
+        ruleTimer()->cancel(this);
+        pending = false;
+        pendingPayload.clear();
+    }
+}
+
 Rule::Rule(QObject *parent)
     : QObject(parent), d_ptr(new RulePrivate(this))
 {
@@ -133,6 +392,11 @@ Rule::Rule(QObject *parent)
 
 Rule::~Rule()
 {
+    Q_D(Rule);
+    d->cancelPending();
+    if (d->dispatcher) {
+        d->dispatcher->remove(this);
+    }
 }
 
 void Rule::classBegin()
@@ -141,6 +405,10 @@ void Rule::classBegin()
 
 void Rule::componentComplete()
 {
+    Q_D(Rule);
+    // The trigger is connected, so the rule handles
+    // events from now on
+    d->liveTimer.start();
 }
 
 QString Rule::name() const
@@ -158,6 +426,36 @@ void Rule::setName(const QString &name)
     }
 }
 
+QUrl Rule::source() const
+{
+    Q_D(const Rule);
+    return d->source;
+}
+
+void Rule::setSource(const QUrl &source)
+{
+    Q_D(Rule);
+    if (d->source == source) {
+        return;
+    }
+
+    d->source = source;
+    ExecutionJournal *journal = ExecutionJournal::instance();
+    if (journal) {
+        d->journalId = journal->registerRule(source.toString());
+    }
+
+    // Sequences are keyed after the rule source and their position, so that
+    // their pending continuations can be resumed when the rule is reloaded
+    for (int i = 0; i < d->actions.count(); ++i) {
+        SequenceAction *sequence = qobject_cast<SequenceAction *>(d->actions.at(i));
+        if (sequence) {
+            sequence->attach(this, QString("%1#%2").arg(source.toString()).arg(i));
+        }
+    }
+    emit sourceChanged();
+}
+
 bool Rule::isEnabled() const
 {
     Q_D(const Rule);
@@ -183,14 +481,15 @@ void Rule::setTrigger(Trigger *trigger)
 {
     Q_D(Rule);
     if (d->trigger != trigger) {
+        d->cancelPending();
         if (d->triggerConnection) {
             disconnect(d->triggerConnection);
             d->triggerConnection = (QMetaObject::Connection());
         }
         d->trigger = trigger;
         if (d->trigger != nullptr) {
-            d->triggerConnection = connect(d->trigger, &Trigger::triggered, [d](){
-                d->slotTriggered();
+            d->triggerConnection = connect(d->trigger, &Trigger::triggered, [d](TriggerEvent *event){
+                d->slotTriggered(event);
             });
         }
         emit triggerChanged();
@@ -230,4 +529,185 @@ QQmlListProperty<AbstractMapper> Rule::mappers()
                                             &RulePrivate::mappers_clear);
 }
 
+int Rule::debounce() const
+{
+    Q_D(const Rule);
+    return d->debounce;
+}
+
+void Rule::setDebounce(int debounce)
+{
+    Q_D(Rule);
+    if (d->debounce != debounce) {
+        d->debounce = debounce;
+        d->cancelPending();
+        emit debounceChanged();
+    }
+}
+
+Rule::DebounceMode Rule::debounceMode() const
+{
+    Q_D(const Rule);
+    return d->debounceMode;
+}
+
+void Rule::setDebounceMode(DebounceMode debounceMode)
+{
+    Q_D(Rule);
+    if (d->debounceMode != debounceMode) {
+        d->debounceMode = debounceMode;
+        d->cancelPending();
+        emit debounceModeChanged();
+    }
+}
+
+int Rule::minimumInterval() const
+{
+    Q_D(const Rule);
+    return d->minimumInterval;
+}
+
+void Rule::setMinimumInterval(int minimumInterval)
+{
+    Q_D(Rule);
+    if (d->minimumInterval != minimumInterval) {
+        d->minimumInterval = minimumInterval;
+        emit minimumIntervalChanged();
+    }
+}
+
+int Rule::maxExecutions() const
+{
+    Q_D(const Rule);
+    return d->maxExecutions;
+}
+
+void Rule::setMaxExecutions(int maxExecutions)
+{
+    Q_D(Rule);
+    if (d->maxExecutions != maxExecutions) {
+        d->maxExecutions = maxExecutions;
+        emit maxExecutionsChanged();
+    }
+}
+
+int Rule::executionWindow() const
+{
+    Q_D(const Rule);
+    return d->executionWindow;
+}
+
+void Rule::setExecutionWindow(int executionWindow)
+{
+    Q_D(Rule);
+    if (d->executionWindow != executionWindow) {
+        d->executionWindow = executionWindow;
+        emit executionWindowChanged();
+    }
+}
+
+int Rule::hysteresis() const
+{
+    Q_D(const Rule);
+    return d->hysteresis;
+}
+
+void Rule::setHysteresis(int hysteresis)
+{
+    Q_D(Rule);
+    if (d->hysteresis != hysteresis) {
+        d->hysteresis = hysteresis;
+        emit hysteresisChanged();
+    }
+}
+
+int Rule::priority() const
+{
+    Q_D(const Rule);
+    return d->priority;
+}
+
+void Rule::setPriority(int priority)
+{
+    Q_D(Rule);
+    if (d->priority != priority) {
+        d->priority = priority;
+        emit priorityChanged();
+    }
+}
+
+RuleDispatcher * Rule::dispatcher() const
+{
+    Q_D(const Rule);
+    return d->dispatcher;
+}
+
+void Rule::setDispatcher(RuleDispatcher *dispatcher)
+{
+    Q_D(Rule);
+    if (d->dispatcher != dispatcher) {
+        if (d->dispatcher) {
+            d->dispatcher->remove(this);
+        }
+        d->dispatcher = dispatcher;
+    }
+}
+
+int Rule::scriptBudget() const
+{
+    Q_D(const Rule);
+    return d->scriptBudget;
+}
+
+void Rule::setScriptBudget(int scriptBudget)
+{
+    Q_D(Rule);
+    if (d->scriptBudget != scriptBudget) {
+        d->scriptBudget = scriptBudget;
+        emit scriptBudgetChanged();
+    }
+}
+
+int Rule::maxScriptOverruns() const
+{
+    Q_D(const Rule);
+    return d->maxScriptOverruns;
+}
+
+void Rule::setMaxScriptOverruns(int maxScriptOverruns)
+{
+    Q_D(Rule);
+    if (d->maxScriptOverruns != maxScriptOverruns) {
+        d->maxScriptOverruns = maxScriptOverruns;
+        emit maxScriptOverrunsChanged();
+    }
+}
+
+int Rule::scriptOverrunCount() const
+{
+    Q_D(const Rule);
+    return d->scriptOverrunCount;
+}
+
+int Rule::droppedCount() const
+{
+    Q_D(const Rule);
+    return d->droppedCount;
+}
+
+int Rule::coalescedCount() const
+{
+    Q_D(const Rule);
+    return d->coalescedCount;
+}
+
+qint64 Rule::liveTime() const
+{
+    Q_D(const Rule);
+    if (!d->liveTimer.isValid()) {
+        return -1;
+    }
+    return d->liveTimer.nsecsElapsed() / 1000;
+}
+
 #include "moc_rule.cpp"
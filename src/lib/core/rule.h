@@ -33,6 +33,7 @@
 #define RULE_H
 
 #include <QtCore/QObject>
+#include <QtCore/QUrl>
 #include <QtQml/QQmlParserStatus>
 #include <QtQml/QQmlListProperty>
 
@@ -40,24 +41,50 @@ class Trigger;
 class Condition;
 class Action;
 class AbstractMapper;
+class RuleDispatcher;
 class RulePrivate;
 class Rule: public QObject, public QQmlParserStatus
 {
     Q_OBJECT
     Q_INTERFACES(QQmlParserStatus)
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(QUrl source READ source NOTIFY sourceChanged)
     Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
     Q_PROPERTY(Trigger * trigger READ trigger WRITE setTrigger NOTIFY triggerChanged)
     Q_PROPERTY(Condition * condition READ condition WRITE setCondition NOTIFY conditionChanged)
     Q_PROPERTY(QQmlListProperty<Action> actions READ actions)
     Q_PROPERTY(QQmlListProperty<AbstractMapper> mappers READ mappers)
+    Q_PROPERTY(int debounce READ debounce WRITE setDebounce NOTIFY debounceChanged)
+    Q_PROPERTY(DebounceMode debounceMode READ debounceMode WRITE setDebounceMode
+               NOTIFY debounceModeChanged)
+    Q_PROPERTY(int minimumInterval READ minimumInterval WRITE setMinimumInterval
+               NOTIFY minimumIntervalChanged)
+    Q_PROPERTY(int maxExecutions READ maxExecutions WRITE setMaxExecutions
+               NOTIFY maxExecutionsChanged)
+    Q_PROPERTY(int executionWindow READ executionWindow WRITE setExecutionWindow
+               NOTIFY executionWindowChanged)
+    Q_PROPERTY(int hysteresis READ hysteresis WRITE setHysteresis NOTIFY hysteresisChanged)
+    Q_PROPERTY(int priority READ priority WRITE setPriority NOTIFY priorityChanged)
+    Q_PROPERTY(int scriptBudget READ scriptBudget WRITE setScriptBudget NOTIFY scriptBudgetChanged)
+    Q_PROPERTY(int maxScriptOverruns READ maxScriptOverruns WRITE setMaxScriptOverruns
+               NOTIFY maxScriptOverrunsChanged)
+    Q_PROPERTY(int scriptOverrunCount READ scriptOverrunCount NOTIFY scriptOverrunCountChanged)
+    Q_PROPERTY(int droppedCount READ droppedCount NOTIFY droppedCountChanged)
+    Q_PROPERTY(int coalescedCount READ coalescedCount NOTIFY coalescedCountChanged)
+    Q_ENUMS(DebounceMode)
 public:
+    enum DebounceMode {
+        Trailing,
+        Leading
+    };
     explicit Rule(QObject *parent = 0);
     virtual ~Rule();
     void classBegin() override;
     void componentComplete() override;
     QString name() const;
     void setName(const QString &name);
+    QUrl source() const;
+    void setSource(const QUrl &source);
     bool isEnabled() const;
     void setEnabled(bool enabled);
     Trigger * trigger() const;
@@ -66,11 +93,49 @@ public:
     void setCondition(Condition *condition);
     QQmlListProperty<Action> actions();
     QQmlListProperty<AbstractMapper> mappers();
+    int debounce() const;
+    void setDebounce(int debounce);
+    DebounceMode debounceMode() const;
+    void setDebounceMode(DebounceMode debounceMode);
+    int minimumInterval() const;
+    void setMinimumInterval(int minimumInterval);
+    int maxExecutions() const;
+    void setMaxExecutions(int maxExecutions);
+    int executionWindow() const;
+    void setExecutionWindow(int executionWindow);
+    int hysteresis() const;
+    void setHysteresis(int hysteresis);
+    int priority() const;
+    void setPriority(int priority);
+    RuleDispatcher * dispatcher() const;
+    void setDispatcher(RuleDispatcher *dispatcher);
+    int scriptBudget() const; // In msecs
+    void setScriptBudget(int scriptBudget);
+    int maxScriptOverruns() const;
+    void setMaxScriptOverruns(int maxScriptOverruns);
+    int scriptOverrunCount() const;
+    int droppedCount() const;
+    int coalescedCount() const;
+    qint64 liveTime() const; // In usecs, since the rule was completed
 Q_SIGNALS:
     void nameChanged();
+    void sourceChanged();
     void enabledChanged();
     void triggerChanged();
     void conditionChanged();
+    void debounceChanged();
+    void debounceModeChanged();
+    void minimumIntervalChanged();
+    void maxExecutionsChanged();
+    void executionWindowChanged();
+    void hysteresisChanged();
+    void priorityChanged();
+    void scriptBudgetChanged();
+    void maxScriptOverrunsChanged();
+    void scriptOverrunCountChanged();
+    void scriptBudgetExhausted();
+    void droppedCountChanged();
+    void coalescedCountChanged();
 protected:
     QScopedPointer<RulePrivate> d_ptr;
 private:
@@ -33,8 +33,15 @@
 #define RULE_P_H
 
 #include "rule.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMetaObject>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QVariantMap>
 
+class RuleDispatcher;
+class TriggerEvent;
 class RulePrivate
 {
 public:
@@ -47,14 +54,47 @@ public:
     static AbstractMapper * mappers_at(QQmlListProperty<AbstractMapper> *list, int index);
     static void mappers_clear(QQmlListProperty<AbstractMapper> *list);
     static int mappers_count(QQmlListProperty<AbstractMapper> *list);
-    void slotTriggered();
+    void slotTriggered(TriggerEvent *event);
+    void slotDebounceTimeout();
+    void run(TriggerEvent *event);
+    void execute(TriggerEvent *event);
+    static void dispatch(Rule *rule, TriggerEvent *event);
+    static int scriptBudget(Rule *rule);
+    static void scriptOverrun(Rule *rule);
+    void drop();
+    void coalesce();
+    void cancelPending();
     QString name;
+    QUrl source;
     bool enabled;
     Trigger *trigger;
     QMetaObject::Connection triggerConnection;
     Condition * condition;
     QList<Action *> actions;
     QList<AbstractMapper *> mappers;
+    int debounce;
+    Rule::DebounceMode debounceMode;
+    int minimumInterval;
+    int maxExecutions;
+    int executionWindow;
+    int hysteresis;
+    int priority;
+    QPointer<RuleDispatcher> dispatcher;
+    int scriptBudget;
+    int maxScriptOverruns;
+    int scriptOverrunCount;
+    int droppedCount;
+    int coalescedCount;
+    quint32 journalId;
+    QElapsedTimer liveTimer;
+    qint64 lastTrigger;
+    qint64 lastExecution;
+    QQueue<qint64> executions;
+    int validStreak;
+    // Last event held back by a trailing debounce
+    bool pending;
+    QDateTime pendingTimestamp;
+    QVariantMap pendingPayload;
 protected:
     Rule * const q_ptr;
 private:
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "ruledispatcher.h"
+#include "clock.h"
+#include "rule.h"
+#include "rule_p.h"
+#include "trigger.h"
+#include "triggerevent.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEvent>
+#include <QtCore/QMap>
+#include <QtCore/QPointer>
+
+struct DispatchEntry
+{
+    Rule *rule;
+    QPointer<Trigger> trigger;
+    QDateTime timestamp;
+    QVariantMap payload;
+    qint64 enqueued;
+};
+
+// Entries are sorted by decreasing priority, and
+// in the order they were queued for a same priority
+typedef QPair<int, quint64> DispatchKey;
+
+class RuleDispatcherPrivate
+{
+public:
+    explicit RuleDispatcherPrivate(RuleDispatcher *q);
+    void scheduleProcessing();
+    void process();
+    bool coalesce(Rule *rule, TriggerEvent *event);
+    bool dropOldest(int priority);
+    void recordWait(qint64 wait);
+    QMap<DispatchKey, DispatchEntry> queue;
+    quint64 sequence;
+    int maxDepth;
+    RuleDispatcher::OverloadPolicy overloadPolicy;
+    bool processingScheduled;
+    int droppedCount;
+    int coalescedCount;
+    qint64 lastWait;
+    qint64 maxWait;
+    qint64 totalWait;
+    qint64 dispatchedCount;
+    QElapsedTimer clock;
+protected:
+    RuleDispatcher * const q_ptr;
+private:
+    Q_DECLARE_PUBLIC(RuleDispatcher)
+};
+
+RuleDispatcherPrivate::RuleDispatcherPrivate(RuleDispatcher *q)
+    : sequence(0), maxDepth(0), overloadPolicy(RuleDispatcher::DropOldest)
+    , processingScheduled(false), droppedCount(0), coalescedCount(0), lastWait(0), maxWait(0)
+    , totalWait(0), dispatchedCount(0), q_ptr(q)
+{
+    clock.start();
+}
+
+void RuleDispatcherPrivate::scheduleProcessing()
+{
+    Q_Q(RuleDispatcher);
+    if (!processingScheduled) {
+        processingScheduled = true;
+        QCoreApplication::postEvent(q, new QEvent(QEvent::User));
+    }
+}
+
+void RuleDispatcherPrivate::process()
+{
+    Q_Q(RuleDispatcher);
+    processingScheduled = false;
+    bool dispatched = !queue.isEmpty();
+    while (!queue.isEmpty()) {
+        DispatchEntry entry = queue.take(queue.firstKey());
+        emit q->depthChanged();
+        recordWait(clock.nsecsElapsed() / 1000 - entry.enqueued);
+        TriggerEvent event (entry.trigger, entry.timestamp, entry.payload);
+        RulePrivate::dispatch(entry.rule, &event);
+    }
+
+    if (dispatched) {
+        emit q->metricsChanged();
+    }
+}
+
+bool RuleDispatcherPrivate::coalesce(Rule *rule, TriggerEvent *event)
+{
+    for (DispatchEntry &entry : queue) {
+        if (entry.rule == rule) {
+            // Keep the position in the queue, but use the latest event
+            entry.trigger = event ? event->trigger() : nullptr;
+            entry.timestamp = event ? event->timestamp() : Clock::instance()->currentDateTime();
+            entry.payload = event ? event->payload() : QVariantMap();
+            ++coalescedCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Drops the oldest of the least important entries to make room for an
+// entry with the given priority. If every queued entry is more important,
+// nothing is removed and the incoming entry is the one to drop.
+bool RuleDispatcherPrivate::dropOldest(int priority)
+{
+    ++droppedCount;
+    int lowestPriority = queue.lastKey().first;
+    if (-priority > lowestPriority) {
+        return false;
+    }
+    queue.erase(queue.lowerBound(DispatchKey(lowestPriority, 0)));
+    return true;
+}
+
+void RuleDispatcherPrivate::recordWait(qint64 wait)
+{
+    lastWait = wait;
+    maxWait = qMax(maxWait, wait);
+    totalWait += wait;
+    ++dispatchedCount;
+}
+
+RuleDispatcher::RuleDispatcher(QObject *parent)
+    : QObject(parent), d_ptr(new RuleDispatcherPrivate(this))
+{
+}
+
+RuleDispatcher::~RuleDispatcher()
+{
+}
+
+int RuleDispatcher::depth() const
+{
+    Q_D(const RuleDispatcher);
+    return d->queue.count();
+}
+
+int RuleDispatcher::maxDepth() const
+{
+    Q_D(const RuleDispatcher);
+    return d->maxDepth;
+}
+
+void RuleDispatcher::setMaxDepth(int maxDepth)
+{
+    Q_D(RuleDispatcher);
+    if (d->maxDepth != maxDepth) {
+        d->maxDepth = maxDepth;
+        emit maxDepthChanged();
+    }
+}
+
+RuleDispatcher::OverloadPolicy RuleDispatcher::overloadPolicy() const
+{
+    Q_D(const RuleDispatcher);
+    return d->overloadPolicy;
+}
+
+void RuleDispatcher::setOverloadPolicy(OverloadPolicy overloadPolicy)
+{
+    Q_D(RuleDispatcher);
+    if (d->overloadPolicy != overloadPolicy) {
+        d->overloadPolicy = overloadPolicy;
+        emit overloadPolicyChanged();
+    }
+}
+
+int RuleDispatcher::droppedCount() const
+{
+    Q_D(const RuleDispatcher);
+    return d->droppedCount;
+}
+
+int RuleDispatcher::coalescedCount() const
+{
+    Q_D(const RuleDispatcher);
+    return d->coalescedCount;
+}
+
+qint64 RuleDispatcher::lastQueueWait() const
+{
+    Q_D(const RuleDispatcher);
+    return d->lastWait;
+}
+
+qint64 RuleDispatcher::maxQueueWait() const
+{
+    Q_D(const RuleDispatcher);
+    return d->maxWait;
+}
+
+qint64 RuleDispatcher::averageQueueWait() const
+{
+    Q_D(const RuleDispatcher);
+    if (d->dispatchedCount == 0) {
+        return 0;
+    }
+    return d->totalWait / d->dispatchedCount;
+}
+
+void RuleDispatcher::resetMetrics()
+{
+    Q_D(RuleDispatcher);
+    d->droppedCount = 0;
+    d->coalescedCount = 0;
+    d->lastWait = 0;
+    d->maxWait = 0;
+    d->totalWait = 0;
+    d->dispatchedCount = 0;
+    emit metricsChanged();
+}
+
+void RuleDispatcher::enqueue(Rule *rule, TriggerEvent *event)
+{
+    Q_D(RuleDispatcher);
+    if (!rule) {
+        return;
+    }
+
+    if (d->maxDepth > 0 && d->queue.count() >= d->maxDepth) {
+        if (d->overloadPolicy == CoalescePerRule && d->coalesce(rule, event)) {
+            emit metricsChanged();
+            return;
+        }
+        bool dropped = d->dropOldest(rule->priority());
+        emit metricsChanged();
+        if (!dropped) {
+            return;
+        }
+    }
+
+    DispatchEntry entry;
+    entry.rule = rule;
+    entry.trigger = event ? event->trigger() : nullptr;
+    entry.timestamp = event ? event->timestamp() : Clock::instance()->currentDateTime();
+    entry.payload = event ? event->payload() : QVariantMap();
+    entry.enqueued = d->clock.nsecsElapsed() / 1000;
+    d->queue.insert(DispatchKey(-rule->priority(), d->sequence++), entry);
+    emit depthChanged();
+    d->scheduleProcessing();
+}
+
+void RuleDispatcher::remove(Rule *rule)
+{
+    Q_D(RuleDispatcher);
+    bool removed = false;
+    QMap<DispatchKey, DispatchEntry>::iterator i = d->queue.begin();
+    while (i != d->queue.end()) {
+        if (i->rule == rule) {
+            i = d->queue.erase(i);
+            removed = true;
+        } else {
+            ++i;
+        }
+    }
+
+    if (removed) {
+        emit depthChanged();
+    }
+}
+
+bool RuleDispatcher::event(QEvent *e)
+{
+    Q_D(RuleDispatcher);
+    if (e->type() == QEvent::User) {
+        d->process();
+        return true;
+    }
+    return QObject::event(e);
+}
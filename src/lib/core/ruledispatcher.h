@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef RULEDISPATCHER_H
+#define RULEDISPATCHER_H
+
+#include <QtCore/QObject>
+
+class Rule;
+class TriggerEvent;
+class RuleDispatcherPrivate;
+class RuleDispatcher : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int depth READ depth NOTIFY depthChanged)
+    Q_PROPERTY(int maxDepth READ maxDepth WRITE setMaxDepth NOTIFY maxDepthChanged)
+    Q_PROPERTY(OverloadPolicy overloadPolicy READ overloadPolicy WRITE setOverloadPolicy
+               NOTIFY overloadPolicyChanged)
+    Q_PROPERTY(int droppedCount READ droppedCount NOTIFY metricsChanged)
+    Q_PROPERTY(int coalescedCount READ coalescedCount NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 lastQueueWait READ lastQueueWait NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 maxQueueWait READ maxQueueWait NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 averageQueueWait READ averageQueueWait NOTIFY metricsChanged)
+    Q_ENUMS(OverloadPolicy)
+public:
+    enum OverloadPolicy {
+        DropOldest,
+        CoalescePerRule
+    };
+    explicit RuleDispatcher(QObject *parent = 0);
+    virtual ~RuleDispatcher();
+    int depth() const;
+    int maxDepth() const;
+    void setMaxDepth(int maxDepth);
+    OverloadPolicy overloadPolicy() const;
+    void setOverloadPolicy(OverloadPolicy overloadPolicy);
+    int droppedCount() const;
+    int coalescedCount() const;
+    qint64 lastQueueWait() const; // In usecs
+    qint64 maxQueueWait() const; // In usecs
+    qint64 averageQueueWait() const; // In usecs
+    void resetMetrics();
+    void enqueue(Rule *rule, TriggerEvent *event);
+    void remove(Rule *rule);
+Q_SIGNALS:
+    void depthChanged();
+    void maxDepthChanged();
+    void overloadPolicyChanged();
+    void metricsChanged();
+protected:
+    bool event(QEvent *e);
+    QScopedPointer<RuleDispatcherPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(RuleDispatcher)
+};
+
+#endif // RULEDISPATCHER_H
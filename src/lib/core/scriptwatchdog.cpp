@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "scriptwatchdog.h"
+#include "phonebotlogging.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+#include <QtQml/QJSEngine>
+
+struct WatchedScript
+{
+    QJSEngine *engine;
+    int budget;
+    qint64 deadline;
+    bool interrupted;
+};
+
+class ScriptWatchdogPrivate
+{
+public:
+    explicit ScriptWatchdogPrivate();
+    QMutex mutex;
+    QWaitCondition condition;
+    QElapsedTimer clock;
+    QMap<quint64, WatchedScript> scripts;
+    quint64 nextToken;
+    bool started;
+    bool stopping;
+};
+
+Q_GLOBAL_STATIC(ScriptWatchdog, watchdog)
+
+ScriptWatchdogPrivate::ScriptWatchdogPrivate()
+    : nextToken(1), started(false), stopping(false)
+{
+    clock.start();
+}
+
+ScriptWatchdog::ScriptWatchdog(QObject *parent)
+    : QThread(parent), d_ptr(new ScriptWatchdogPrivate())
+{
+    setObjectName("phonebot-watchdog");
+}
+
+ScriptWatchdog::~ScriptWatchdog()
+{
+    Q_D(ScriptWatchdog);
+    {
+        QMutexLocker locker (&d->mutex);
+        d->stopping = true;
+        d->condition.wakeAll();
+    }
+    wait();
+}
+
+ScriptWatchdog * ScriptWatchdog::instance()
+{
+    return watchdog();
+}
+
+quint64 ScriptWatchdog::arm(QJSEngine *engine, int budget)
+{
+    Q_D(ScriptWatchdog);
+    if (!engine || budget <= 0) {
+        return 0;
+    }
+
+    QMutexLocker locker (&d->mutex);
+    if (!d->started) {
+        d->started = true;
+        start(QThread::HighPriority);
+    }
+
+    WatchedScript script;
+    script.engine = engine;
+    script.budget = budget;
+    script.deadline = d->clock.elapsed() + budget;
+    script.interrupted = false;
+    quint64 token = d->nextToken++;
+    d->scripts.insert(token, script);
+    d->condition.wakeAll();
+    return token;
+}
+
+bool ScriptWatchdog::disarm(quint64 token)
+{
+    Q_D(ScriptWatchdog);
+    if (token == 0) {
+        return false;
+    }
+
+    QMutexLocker locker (&d->mutex);
+    if (!d->scripts.contains(token)) {
+        return false;
+    }
+
+    WatchedScript script = d->scripts.take(token);
+    bool exceeded = script.interrupted || d->clock.elapsed() > script.deadline;
+    if (script.interrupted) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        // Let the engine run scripts again
+        script.engine->setInterrupted(false);
+#endif
+    }
+    return exceeded;
+}
+
+void ScriptWatchdog::run()
+{
+    Q_D(ScriptWatchdog);
+    QMutexLocker locker (&d->mutex);
+    while (!d->stopping) {
+        qint64 now = d->clock.elapsed();
+        qint64 next = -1;
+        for (QMap<quint64, WatchedScript>::iterator i = d->scripts.begin(); i != d->scripts.end(); ++i) {
+            if (i->interrupted) {
+                continue;
+            }
+
+            if (i->deadline <= now) {
+                i->interrupted = true;
+                qCWarning(phonebotCore) << "Script exceeded its budget of" << i->budget << "ms, interrupting it";
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+                i->engine->setInterrupted(true);
+#endif
+            } else if (next == -1 || i->deadline < next) {
+                next = i->deadline;
+            }
+        }
+
+        // Older Qt versions cannot interrupt a running script. The
+        // overrun is then only reported when the script returns.
+        if (next == -1) {
+            d->condition.wait(&d->mutex);
+        } else {
+            d->condition.wait(&d->mutex, static_cast<unsigned long>(next - now));
+        }
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "sequenceaction.h"
+#include "action_p.h"
+#include "clock.h"
+#include "continuationscheduler.h"
+#include "delayaction.h"
+#include "rule.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QPointer>
+
+class SequenceActionPrivate: public ActionPrivate
+{
+public:
+    explicit SequenceActionPrivate(Action *q);
+    bool run(int step, TriggerEvent *event);
+    static void actions_append(QQmlListProperty<Action> *list, Action *action);
+    static Action * actions_at(QQmlListProperty<Action> *list, int index);
+    static void actions_clear(QQmlListProperty<Action> *list);
+    static int actions_count(QQmlListProperty<Action> *list);
+    QList<Action *> actions;
+    QPointer<Rule> rule;
+    QString key;
+private:
+    Q_DECLARE_PUBLIC(SequenceAction)
+};
+
+SequenceActionPrivate::SequenceActionPrivate(Action *q)
+    : ActionPrivate(q)
+{
+}
+
+bool SequenceActionPrivate::run(int step, TriggerEvent *event)
+{
+    Q_Q(SequenceAction);
+    bool ok = true;
+    for (int i = step; i < actions.count(); ++i) {
+        Action *action = actions.at(i);
+        if (!action->isEnabled()) {
+            continue;
+        }
+
+        // The remaining actions are run later, from the shared scheduler
+        DelayAction *delay = qobject_cast<DelayAction *>(action);
+        if (delay) {
+            if (delay->duration() > 0) {
+                QDateTime deadline = Clock::instance()->currentDateTime().addMSecs(delay->duration());
+                ContinuationScheduler::instance()->schedule(q, i + 1, deadline, event);
+                return ok;
+            }
+            continue;
+        }
+
+        if (!action->execute(rule, event)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void SequenceActionPrivate::actions_append(QQmlListProperty<Action> *list, Action *action)
+{
+    SequenceAction *sequence = qobject_cast<SequenceAction *>(list->object);
+    Q_ASSERT(sequence);
+    if (action != nullptr) {
+        sequence->d_func()->actions.append(action);
+    }
+}
+
+Action * SequenceActionPrivate::actions_at(QQmlListProperty<Action> *list, int index)
+{
+    SequenceAction *sequence = qobject_cast<SequenceAction *>(list->object);
+    Q_ASSERT(sequence);
+    Q_ASSERT(index >= 0 && index < sequence->d_func()->actions.count());
+    return sequence->d_func()->actions.at(index);
+}
+
+void SequenceActionPrivate::actions_clear(QQmlListProperty<Action> *list)
+{
+    SequenceAction *sequence = qobject_cast<SequenceAction *>(list->object);
+    Q_ASSERT(sequence);
+    sequence->d_func()->actions.clear();
+}
+
+int SequenceActionPrivate::actions_count(QQmlListProperty<Action> *list)
+{
+    SequenceAction *sequence = qobject_cast<SequenceAction *>(list->object);
+    Q_ASSERT(sequence);
+    return sequence->d_func()->actions.count();
+}
+
+SequenceAction::SequenceAction(QObject *parent) :
+    Action(*(new SequenceActionPrivate(this)), parent)
+{
+}
+
+SequenceAction::~SequenceAction()
+{
+    Q_D(SequenceAction);
+    // Anonymous continuations can never be resumed
+    if (d->key.isEmpty()) {
+        ContinuationScheduler::instance()->cancel(this);
+    }
+}
+
+QQmlListProperty<Action> SequenceAction::actions()
+{
+    return QQmlListProperty<Action>(this, nullptr,
+                                    &SequenceActionPrivate::actions_append,
+                                    &SequenceActionPrivate::actions_count,
+                                    &SequenceActionPrivate::actions_at,
+                                    &SequenceActionPrivate::actions_clear);
+}
+
+QString SequenceAction::key() const
+{
+    Q_D(const SequenceAction);
+    return d->key;
+}
+
+void SequenceAction::attach(Rule *rule, const QString &key)
+{
+    Q_D(SequenceAction);
+    d->rule = rule;
+    if (d->key != key) {
+        d->key = key;
+        emit keyChanged();
+    }
+
+    // Nested sequences are keyed after their position in this sequence
+    for (int i = 0; i < d->actions.count(); ++i) {
+        SequenceAction *sequence = qobject_cast<SequenceAction *>(d->actions.at(i));
+        if (sequence) {
+            sequence->attach(rule, QString("%1/%2").arg(key).arg(i));
+        }
+    }
+
+    ContinuationScheduler::instance()->attach(this);
+}
+
+bool SequenceAction::execute(Rule *rule, TriggerEvent *event)
+{
+    Q_D(SequenceAction);
+    d->rule = rule;
+
+    // A new execution restarts the sequence
+    ContinuationScheduler::instance()->cancel(this);
+    return d->run(0, event);
+}
+
+void SequenceAction::resume(int step, TriggerEvent *event)
+{
+    Q_D(SequenceAction);
+    if (!isEnabled() || (d->rule && !d->rule->isEnabled())) {
+        return;
+    }
+    d->run(step, event);
+}
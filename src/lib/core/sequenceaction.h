@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef SEQUENCEACTION_H
+#define SEQUENCEACTION_H
+
+#include "action.h"
+#include <QtQml/QQmlListProperty>
+
+class SequenceActionPrivate;
+class SequenceAction : public Action
+{
+    Q_OBJECT
+    Q_PROPERTY(QQmlListProperty<Action> actions READ actions)
+    Q_PROPERTY(QString key READ key NOTIFY keyChanged)
+    Q_CLASSINFO("DefaultProperty", "actions")
+public:
+    explicit SequenceAction(QObject *parent = 0);
+    virtual ~SequenceAction();
+    QQmlListProperty<Action> actions();
+    QString key() const;
+    void attach(Rule *rule, const QString &key);
+    bool execute(Rule *rule, TriggerEvent *event) override;
+    void resume(int step, TriggerEvent *event);
+Q_SIGNALS:
+    void keyChanged();
+private:
+    Q_DECLARE_PRIVATE(SequenceAction)
+};
+
+#endif // SEQUENCEACTION_H
@@ -31,7 +31,6 @@
 
 #include "timemapper.h"
 #include "abstractmapper_p.h"
-#include <QtCore/QTime>
 
 class TimeMapperPrivate: public AbstractMapperPrivate
 {
@@ -55,17 +54,22 @@ void TimeMapperPrivate::setTime()
 {
     Q_Q(TimeMapper);
     if (hour >= 0 && hour < 24 && minute >= 0 && minute < 60) {
-        q->setValue(QTime(hour, minute));
+        q->setTypedValue(QTime(hour, minute));
     } else {
-        q->setValue(QTime());
+        q->setTypedValue(QTime());
     }
 }
 
 TimeMapper::TimeMapper(QObject *parent) :
-    AbstractMapper(*(new TimeMapperPrivate(this)), parent)
+    TypedMapper<QTime>(*(new TimeMapperPrivate(this)), parent)
 {
 }
 
+QTime TimeMapper::time() const
+{
+    return typedValue();
+}
+
 int TimeMapper::hour() const
 {
     Q_D(const TimeMapper);
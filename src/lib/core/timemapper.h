@@ -32,16 +32,19 @@
 #ifndef TIMEMAPPER_H
 #define TIMEMAPPER_H
 
-#include "abstractmapper.h"
+#include <QtCore/QTime>
+#include "typedmapper.h"
 
 class TimeMapperPrivate;
-class TimeMapper : public AbstractMapper
+class TimeMapper : public TypedMapper<QTime>
 {
     Q_OBJECT
     Q_PROPERTY(int hour READ hour WRITE setHour NOTIFY hourChanged)
     Q_PROPERTY(int minute READ minute WRITE setMinute NOTIFY minuteChanged)
+    Q_PROPERTY(QTime time READ time NOTIFY valueChanged)
 public:
     explicit TimeMapper(QObject *parent = 0);
+    QTime time() const;
     int hour() const;
     void setHour(int hour);
     int minute() const;
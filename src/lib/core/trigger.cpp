@@ -31,24 +31,42 @@
 
 #include "trigger.h"
 #include "trigger_p.h"
+#include "clock.h"
+#include "triggerevent.h"
+#include "triggeringress.h"
 
 TriggerPrivate::TriggerPrivate(Trigger *q)
-    : enabled(true), q_ptr(q)
+    : enabled(true), passive(false), ingress(nullptr), ingressId(0), q_ptr(q)
 {
 }
 
+void TriggerPrivate::registerToIngress()
+{
+    Q_Q(Trigger);
+    // Events posted from other threads are
+    // delivered in the thread of the trigger
+    ingress = TriggerIngress::instance();
+    ingressId = ingress->registerTrigger(q);
+}
+
 Trigger::Trigger(QObject *parent)
     : QObject(parent), d_ptr(new TriggerPrivate(this))
 {
+    Q_D(Trigger);
+    d->registerToIngress();
 }
 
 Trigger::Trigger(TriggerPrivate &dd, QObject *parent)
     : QObject(parent), d_ptr(&dd)
 {
+    Q_D(Trigger);
+    d->registerToIngress();
 }
 
 Trigger::~Trigger()
 {
+    Q_D(Trigger);
+    d->ingress->unregisterTrigger(d->ingressId);
 }
 
 void Trigger::classBegin()
@@ -59,3 +77,36 @@ void Trigger::componentComplete()
 {
 }
 
+QDateTime Trigger::nextTriggerTime() const
+{
+    return QDateTime();
+}
+
+bool Trigger::isPassive() const
+{
+    Q_D(const Trigger);
+    return d->passive;
+}
+
+void Trigger::setPassive(bool passive)
+{
+    Q_D(Trigger);
+    d->passive = passive;
+}
+
+void Trigger::fire(const QVariantMap &payload, const QDateTime &timestamp)
+{
+    // The event is captured once, so that conditions and
+    // actions all see the same instant and data
+    TriggerEvent event (this, timestamp.isValid() ? timestamp : Clock::instance()->currentDateTime(),
+                        payload);
+    emit triggered(&event);
+}
+
+bool Trigger::post(const QVariantMap &payload, const QDateTime &timestamp)
+{
+    Q_D(Trigger);
+    // Thread-safe: backends running in their own thread push
+    // events without allocating a queued call per event
+    return d->ingress->post(d->ingressId, payload, timestamp);
+}
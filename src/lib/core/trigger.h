@@ -32,9 +32,12 @@
 #ifndef TRIGGER_H
 #define TRIGGER_H
 
+#include <QtCore/QDateTime>
 #include <QtCore/QObject>
+#include <QtCore/QVariantMap>
 #include <QtQml/QQmlParserStatus>
 
+class TriggerEvent;
 class TriggerPrivate;
 class Trigger: public QObject, public QQmlParserStatus
 {
@@ -45,8 +48,20 @@ public:
     virtual ~Trigger();
     void classBegin() override;
     void componentComplete() override;
+    virtual QDateTime nextTriggerTime() const;
+    // Passive triggers stop firing from their own sources, like
+    // timers, and only fire through fire() and post(). They are used
+    // to replay recorded events without emitting them twice.
+    bool isPassive() const;
+    void setPassive(bool passive);
+    void fire(const QVariantMap &payload = QVariantMap(), const QDateTime &timestamp = QDateTime());
+    bool post(const QVariantMap &payload = QVariantMap(), const QDateTime &timestamp = QDateTime());
 Q_SIGNALS:
-    void triggered();
+    // The event lives on the stack of fire(), and is only valid
+    // during the emission. It must be received with a direct
+    // connection, and receivers that defer their work copy the
+    // timestamp and payload instead of keeping the pointer.
+    void triggered(TriggerEvent *event);
 protected:
     explicit Trigger(TriggerPrivate &dd, QObject *parent);
     QScopedPointer<TriggerPrivate> d_ptr;
@@ -34,11 +34,16 @@
 
 #include "trigger.h"
 
+class TriggerIngress;
 class TriggerPrivate
 {
 public:
     explicit TriggerPrivate(Trigger *q);
+    void registerToIngress();
     bool enabled;
+    bool passive;
+    TriggerIngress *ingress;
+    quint32 ingressId;
 protected:
     Trigger * const q_ptr;
 private:
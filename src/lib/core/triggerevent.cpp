@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "triggerevent.h"
+#include "trigger.h"
+
+class TriggerEventPrivate
+{
+public:
+    explicit TriggerEventPrivate(Trigger *trigger, const QDateTime &timestamp,
+                                 const QVariantMap &payload);
+    Trigger *trigger;
+    QDateTime timestamp;
+    QVariantMap payload;
+};
+
+TriggerEventPrivate::TriggerEventPrivate(Trigger *trigger, const QDateTime &timestamp,
+                                         const QVariantMap &payload)
+    : trigger(trigger), timestamp(timestamp), payload(payload)
+{
+}
+
+TriggerEvent::TriggerEvent(Trigger *trigger, const QDateTime &timestamp,
+                           const QVariantMap &payload, QObject *parent)
+    : QObject(parent), d_ptr(new TriggerEventPrivate(trigger, timestamp, payload))
+{
+}
+
+TriggerEvent::~TriggerEvent()
+{
+}
+
+QDateTime TriggerEvent::timestamp() const
+{
+    Q_D(const TriggerEvent);
+    return d->timestamp;
+}
+
+Trigger * TriggerEvent::trigger() const
+{
+    Q_D(const TriggerEvent);
+    return d->trigger;
+}
+
+QVariantMap TriggerEvent::payload() const
+{
+    Q_D(const TriggerEvent);
+    return d->payload;
+}
+
+QVariant TriggerEvent::value(const QString &key) const
+{
+    Q_D(const TriggerEvent);
+    return d->payload.value(key);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef TRIGGEREVENT_H
+#define TRIGGEREVENT_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+class Trigger;
+class TriggerEventPrivate;
+class TriggerEvent : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QDateTime timestamp READ timestamp CONSTANT)
+    Q_PROPERTY(Trigger * trigger READ trigger CONSTANT)
+    Q_PROPERTY(QVariantMap payload READ payload CONSTANT)
+public:
+    explicit TriggerEvent(Trigger *trigger, const QDateTime &timestamp,
+                          const QVariantMap &payload = QVariantMap(), QObject *parent = 0);
+    virtual ~TriggerEvent();
+    QDateTime timestamp() const;
+    Trigger * trigger() const;
+    QVariantMap payload() const;
+    Q_INVOKABLE QVariant value(const QString &key) const;
+protected:
+    QScopedPointer<TriggerEventPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(TriggerEvent)
+};
+
+#endif // TRIGGEREVENT_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "triggeringress.h"
+#include "mpscqueue.h"
+#include "trigger.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QHash>
+#include <QtCore/QThreadStorage>
+
+static const int DEFAULT_CAPACITY = 1024;
+static const int DEFAULT_BATCH_SIZE = 64;
+
+struct IngressEvent
+{
+    IngressEvent() : trigger(0), stamped(false), timestamp(0) {}
+    quint32 trigger;
+    bool stamped;
+    qint64 timestamp; // In msecs since epoch
+    QVariantMap payload;
+};
+
+class TriggerIngressPrivate
+{
+public:
+    explicit TriggerIngressPrivate(int capacity, TriggerIngress *q);
+    void wake();
+    MpscQueue<IngressEvent> queue;
+    std::atomic<bool> wakePending;
+    std::atomic<quint64> postedCount;
+    std::atomic<quint64> drainedCount;
+    std::atomic<quint64> overflowCount;
+    // Only used from the thread of the ingress
+    QHash<quint32, Trigger *> triggers;
+    quint32 nextId;
+    int batchSize;
+protected:
+    TriggerIngress * const q_ptr;
+private:
+    Q_DECLARE_PUBLIC(TriggerIngress)
+};
+
+static QThreadStorage<TriggerIngress *> ingresses;
+
+TriggerIngressPrivate::TriggerIngressPrivate(int capacity, TriggerIngress *q)
+    : queue(capacity), wakePending(false), postedCount(0), drainedCount(0), overflowCount(0)
+    , nextId(1), batchSize(DEFAULT_BATCH_SIZE), q_ptr(q)
+{
+}
+
+void TriggerIngressPrivate::wake()
+{
+    Q_Q(TriggerIngress);
+    // A single event is posted for a burst of pushes,
+    // it is cleared when the consumer starts draining
+    if (!wakePending.exchange(true)) {
+        QCoreApplication::postEvent(q, new QEvent(QEvent::User));
+    }
+}
+
+TriggerIngress::TriggerIngress(int capacity, QObject *parent)
+    : QObject(parent), d_ptr(new TriggerIngressPrivate(capacity, this))
+{
+}
+
+TriggerIngress::~TriggerIngress()
+{
+}
+
+TriggerIngress * TriggerIngress::instance()
+{
+    // Triggers living in the same thread share a single ingress
+    if (!ingresses.hasLocalData()) {
+        ingresses.setLocalData(new TriggerIngress(DEFAULT_CAPACITY));
+    }
+    return ingresses.localData();
+}
+
+int TriggerIngress::capacity() const
+{
+    Q_D(const TriggerIngress);
+    return d->queue.capacity();
+}
+
+int TriggerIngress::batchSize() const
+{
+    Q_D(const TriggerIngress);
+    return d->batchSize;
+}
+
+void TriggerIngress::setBatchSize(int batchSize)
+{
+    Q_D(TriggerIngress);
+    batchSize = qMax(batchSize, 1);
+    if (d->batchSize != batchSize) {
+        d->batchSize = batchSize;
+        emit batchSizeChanged();
+    }
+}
+
+quint64 TriggerIngress::postedCount() const
+{
+    Q_D(const TriggerIngress);
+    return d->postedCount.load(std::memory_order_relaxed);
+}
+
+quint64 TriggerIngress::drainedCount() const
+{
+    Q_D(const TriggerIngress);
+    return d->drainedCount.load(std::memory_order_relaxed);
+}
+
+quint64 TriggerIngress::overflowCount() const
+{
+    Q_D(const TriggerIngress);
+    return d->overflowCount.load(std::memory_order_relaxed);
+}
+
+quint32 TriggerIngress::registerTrigger(Trigger *trigger)
+{
+    Q_D(TriggerIngress);
+    quint32 id = d->nextId++;
+    d->triggers.insert(id, trigger);
+    return id;
+}
+
+void TriggerIngress::unregisterTrigger(quint32 id)
+{
+    Q_D(TriggerIngress);
+    d->triggers.remove(id);
+}
+
+bool TriggerIngress::post(quint32 id, const QVariantMap &payload, const QDateTime &timestamp)
+{
+    Q_D(TriggerIngress);
+    IngressEvent event;
+    event.trigger = id;
+    event.stamped = timestamp.isValid();
+    event.timestamp = event.stamped ? timestamp.toMSecsSinceEpoch() : 0;
+    event.payload = payload;
+    if (!d->queue.push(event)) {
+        d->overflowCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    d->postedCount.fetch_add(1, std::memory_order_relaxed);
+    d->wake();
+    return true;
+}
+
+int TriggerIngress::drain()
+{
+    Q_D(TriggerIngress);
+    d->wakePending.store(false);
+
+    // Events are drained in batches, so that a flooding
+    // producer cannot starve the rest of the event loop
+    int drained = 0;
+    IngressEvent event;
+    while (drained < d->batchSize && d->queue.pop(event)) {
+        ++drained;
+        // Events posted without a timestamp are stamped by the clock
+        // of the ingress thread, as producer threads use the system
+        // clock even when a simulated one is installed
+        Trigger *trigger = d->triggers.value(event.trigger);
+        if (trigger) {
+            trigger->fire(event.payload, event.stamped ? QDateTime::fromMSecsSinceEpoch(event.timestamp)
+                                                       : QDateTime());
+        }
+    }
+
+    d->drainedCount.fetch_add(drained, std::memory_order_relaxed);
+    if (drained == d->batchSize) {
+        d->wake();
+    }
+    return drained;
+}
+
+bool TriggerIngress::event(QEvent *e)
+{
+    if (e->type() == QEvent::User) {
+        drain();
+        return true;
+    }
+    return QObject::event(e);
+}
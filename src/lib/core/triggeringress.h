@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef TRIGGERINGRESS_H
+#define TRIGGERINGRESS_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+class Trigger;
+class TriggerIngressPrivate;
+class TriggerIngress : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int capacity READ capacity CONSTANT)
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize NOTIFY batchSizeChanged)
+public:
+    explicit TriggerIngress(int capacity, QObject *parent = 0);
+    virtual ~TriggerIngress();
+    static TriggerIngress * instance();
+    int capacity() const;
+    int batchSize() const;
+    void setBatchSize(int batchSize);
+    quint64 postedCount() const;
+    quint64 drainedCount() const;
+    quint64 overflowCount() const;
+    quint32 registerTrigger(Trigger *trigger);
+    void unregisterTrigger(quint32 id);
+    bool post(quint32 id, const QVariantMap &payload, const QDateTime &timestamp = QDateTime());
+    int drain();
+Q_SIGNALS:
+    void batchSizeChanged();
+protected:
+    bool event(QEvent *e);
+    QScopedPointer<TriggerIngressPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(TriggerIngress)
+};
+
+#endif // TRIGGERINGRESS_H
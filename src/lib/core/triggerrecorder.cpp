@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "triggerrecorder.h"
+#include "triggertraceformat.h"
+#include "clock.h"
+#include "phonebotlogging.h"
+#include "triggerevent.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+static const int FLUSH_INTERVAL = 64;
+
+class TriggerRecorderPrivate
+{
+public:
+    explicit TriggerRecorderPrivate();
+    QFile file;
+    QDataStream stream;
+    QHash<QString, quint32> rules;
+    QMutex mutex;
+    qint64 count;
+};
+
+static TriggerRecorder *recorder = nullptr;
+
+TriggerRecorderPrivate::TriggerRecorderPrivate()
+    : count(0)
+{
+}
+
+TriggerRecorder::TriggerRecorder()
+    : d_ptr(new TriggerRecorderPrivate())
+{
+}
+
+TriggerRecorder::~TriggerRecorder()
+{
+    flush();
+}
+
+TriggerRecorder * TriggerRecorder::instance()
+{
+    return recorder;
+}
+
+bool TriggerRecorder::open(const QString &path)
+{
+    close();
+    TriggerRecorder *opened = new TriggerRecorder();
+    TriggerRecorderPrivate *d = opened->d_func();
+    d->file.setFileName(path);
+    if (!d->file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(phonebotCore) << "Failed to open the trigger trace" << path;
+        delete opened;
+        return false;
+    }
+
+    d->stream.setDevice(&d->file);
+    d->stream.setVersion(QDataStream::Qt_5_0);
+    d->stream << TRACE_MAGIC << TRACE_VERSION;
+    recorder = opened;
+    return true;
+}
+
+void TriggerRecorder::close()
+{
+    delete recorder;
+    recorder = nullptr;
+}
+
+QString TriggerRecorder::path() const
+{
+    Q_D(const TriggerRecorder);
+    return d->file.fileName();
+}
+
+qint64 TriggerRecorder::count() const
+{
+    Q_D(const TriggerRecorder);
+    QMutexLocker locker (&const_cast<TriggerRecorderPrivate *>(d)->mutex);
+    return d->count;
+}
+
+void TriggerRecorder::record(const QString &rule, TriggerEvent *event)
+{
+    Q_D(TriggerRecorder);
+    // Rules of the worker engines are recorded from several threads
+    QMutexLocker locker (&d->mutex);
+    QHash<QString, quint32>::const_iterator it = d->rules.constFind(rule);
+    quint32 id = 0;
+    if (it == d->rules.constEnd()) {
+        id = d->rules.count() + 1;
+        d->rules.insert(rule, id);
+        d->stream << quint8(TraceRuleDefined) << id << rule;
+    } else {
+        id = it.value();
+    }
+
+    QDateTime timestamp = event ? event->timestamp() : Clock::instance()->currentDateTime();
+    QVariantMap payload = event ? event->payload() : QVariantMap();
+    d->stream << quint8(TraceTriggerFired) << id << timestamp.toMSecsSinceEpoch() << payload;
+    ++d->count;
+    if (d->count % FLUSH_INTERVAL == 0) {
+        d->file.flush();
+    }
+}
+
+void TriggerRecorder::flush()
+{
+    Q_D(TriggerRecorder);
+    QMutexLocker locker (&d->mutex);
+    if (d->file.isOpen()) {
+        d->file.flush();
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "triggertracereader.h"
+#include "triggertraceformat.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+class TriggerTraceReaderPrivate
+{
+public:
+    QFile file;
+    QDataStream stream;
+    QHash<quint32, QString> rules;
+    QString errorString;
+};
+
+TriggerTraceReader::TriggerTraceReader()
+    : d_ptr(new TriggerTraceReaderPrivate())
+{
+}
+
+TriggerTraceReader::~TriggerTraceReader()
+{
+}
+
+bool TriggerTraceReader::open(const QString &path)
+{
+    Q_D(TriggerTraceReader);
+    d->rules.clear();
+    d->errorString.clear();
+    d->file.close();
+    d->file.setFileName(path);
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        d->errorString = d->file.errorString();
+        return false;
+    }
+
+    d->stream.setDevice(&d->file);
+    d->stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    d->stream >> magic >> version;
+    if (magic != TRACE_MAGIC || version != TRACE_VERSION) {
+        d->errorString = QString("%1 is not a trigger trace in a supported format").arg(path);
+        return false;
+    }
+    return true;
+}
+
+bool TriggerTraceReader::readNext(TriggerTraceEvent &event)
+{
+    Q_D(TriggerTraceReader);
+    while (!d->stream.atEnd()) {
+        quint8 kind = 0;
+        quint32 id = 0;
+        d->stream >> kind >> id;
+        switch (kind) {
+        case TraceRuleDefined: {
+            QString rule;
+            d->stream >> rule;
+            d->rules.insert(id, rule);
+            break;
+        }
+        case TraceTriggerFired:
+            event.rule = d->rules.value(id);
+            d->stream >> event.timestamp >> event.payload;
+            break;
+        default:
+            d->errorString = QString("Unknown record kind %1").arg(kind);
+            return false;
+        }
+
+        // The recorder might have been stopped in the middle of a record
+        if (d->stream.status() != QDataStream::Ok) {
+            d->errorString = "The trace is truncated";
+            return false;
+        }
+        if (kind == TraceTriggerFired) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString TriggerTraceReader::errorString() const
+{
+    Q_D(const TriggerTraceReader);
+    return d->errorString;
+}
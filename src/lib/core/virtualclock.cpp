@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "virtualclock.h"
+#include "clocktimer.h"
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+
+// Timers with the same deadline are fired in the order they were scheduled
+typedef QPair<qint64, quint64> TimerKey;
+
+class VirtualClockPrivate
+{
+public:
+    explicit VirtualClockPrivate(qint64 start);
+    qint64 start;
+    qint64 now;
+    quint64 sequence;
+    QMap<TimerKey, ClockTimer *> timers;
+    QHash<ClockTimer *, TimerKey> keys;
+};
+
+VirtualClockPrivate::VirtualClockPrivate(qint64 start)
+    : start(start), now(start), sequence(0)
+{
+}
+
+VirtualClock::VirtualClock(const QDateTime &start, QObject *parent)
+    : Clock(parent), d_ptr(new VirtualClockPrivate(start.toMSecsSinceEpoch()))
+{
+}
+
+VirtualClock::~VirtualClock()
+{
+    Q_D(VirtualClock);
+    foreach (ClockTimer *timer, d->keys.keys()) {
+        timer->stop();
+    }
+}
+
+bool VirtualClock::isSimulated() const
+{
+    return true;
+}
+
+qint64 VirtualClock::now() const
+{
+    Q_D(const VirtualClock);
+    return d->now;
+}
+
+qint64 VirtualClock::elapsed() const
+{
+    Q_D(const VirtualClock);
+    return d->now - d->start;
+}
+
+int VirtualClock::pendingTimerCount() const
+{
+    Q_D(const VirtualClock);
+    return d->timers.count();
+}
+
+QDateTime VirtualClock::nextTimerDateTime() const
+{
+    Q_D(const VirtualClock);
+    if (d->timers.isEmpty()) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(d->timers.firstKey().first);
+}
+
+void VirtualClock::advance(qint64 msecs)
+{
+    Q_D(VirtualClock);
+    advanceTo(QDateTime::fromMSecsSinceEpoch(d->now + qMax<qint64>(0, msecs)));
+}
+
+void VirtualClock::advanceTo(const QDateTime &dateTime)
+{
+    Q_D(VirtualClock);
+    qint64 target = dateTime.toMSecsSinceEpoch();
+    quint64 pass = d->sequence;
+    QList<QPair<TimerKey, ClockTimer *> > deferred;
+    // Fired timers might schedule or cancel others,
+    // so the first timer is looked up each time
+    while (!d->timers.isEmpty() && d->timers.firstKey().first <= target) {
+        QMap<TimerKey, ClockTimer *>::iterator first = d->timers.begin();
+        ClockTimer *timer = first.value();
+
+        // Timers started with no delay by a fired timer, including
+        // repeating timers with a zero interval, are fired once per
+        // pass, like zero timers in an event loop
+        if (first.key().second >= pass && first.key().first == d->now) {
+            deferred.append(qMakePair(first.key(), timer));
+            d->timers.erase(first);
+            continue;
+        }
+
+        d->now = qMax(d->now, first.key().first);
+        d->timers.erase(first);
+        d->keys.remove(timer);
+        fire(timer);
+    }
+    d->now = qMax(d->now, target);
+
+    // Deferred timers that were stopped or restarted meanwhile are dropped
+    for (const QPair<TimerKey, ClockTimer *> &entry : deferred) {
+        QHash<ClockTimer *, TimerKey>::const_iterator i = d->keys.constFind(entry.second);
+        if (i != d->keys.constEnd() && i.value() == entry.first) {
+            d->timers.insert(entry.first, entry.second);
+        }
+    }
+}
+
+bool VirtualClock::advanceToNextTimer()
+{
+    Q_D(VirtualClock);
+    if (d->timers.isEmpty()) {
+        return false;
+    }
+    advanceTo(QDateTime::fromMSecsSinceEpoch(d->timers.firstKey().first));
+    return true;
+}
+
+void VirtualClock::schedule(ClockTimer *timer, int msec)
+{
+    Q_D(VirtualClock);
+    cancel(timer);
+    TimerKey key (d->now + msec, d->sequence++);
+    d->timers.insert(key, timer);
+    d->keys.insert(timer, key);
+}
+
+void VirtualClock::cancel(ClockTimer *timer)
+{
+    Q_D(VirtualClock);
+    QHash<ClockTimer *, TimerKey>::iterator i = d->keys.find(timer);
+    if (i != d->keys.end()) {
+        d->timers.remove(i.value());
+        d->keys.erase(i);
+    }
+}
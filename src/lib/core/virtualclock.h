@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef VIRTUALCLOCK_H
+#define VIRTUALCLOCK_H
+
+#include "clock.h"
+
+// Clock whose time only moves when it is advanced
+//
+// Timers that are due are fired in order while advancing, with the
+// clock set to their deadline, so months of schedules can be simulated
+// in a few seconds. Events posted by the fired timers are not
+// processed while advancing.
+class VirtualClockPrivate;
+class VirtualClock : public Clock
+{
+    Q_OBJECT
+public:
+    explicit VirtualClock(const QDateTime &start, QObject *parent = 0);
+    virtual ~VirtualClock();
+    bool isSimulated() const override;
+    qint64 now() const override;
+    qint64 elapsed() const override;
+    int pendingTimerCount() const;
+    QDateTime nextTimerDateTime() const;
+    void advance(qint64 msecs);
+    void advanceTo(const QDateTime &dateTime);
+    bool advanceToNextTimer();
+protected:
+    void schedule(ClockTimer *timer, int msec) override;
+    void cancel(ClockTimer *timer) override;
+    QScopedPointer<VirtualClockPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(VirtualClock)
+};
+
+#endif // VIRTUALCLOCK_H
@@ -3,7 +3,7 @@ TARGET = phonebotdaemon
 
 system(qdbusxml2cpp dbus/org.SfietKonstantin.phonebot.xml -i enginemanager.h -a adaptor)
 
-QT = core qml
+QT = core qml qml-private
 
 CONFIG += staticlib
 
@@ -11,12 +11,16 @@ include(../../config.pri)
 
 INCLUDEPATH += ../../lib/core
 LIBS += -L../../lib/core -lphonebot
+INCLUDEPATH += ../../lib/meta
+LIBS += -L../../lib/meta -lphonebotmeta
 
 HEADERS += \
     adaptor.h \
-    enginemanager.h
+    enginemanager.h \
+    engineworker.h
 
 SOURCES += \
     adaptor.cpp \
-    enginemanager.cpp
+    enginemanager.cpp \
+    engineworker.cpp
 
@@ -31,29 +31,106 @@
 
 #include "enginemanager.h"
 #include <QtCore/QCoreApplication>
-#include <QtCore/QDebug>
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QLoggingCategory>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <continuationscheduler.h>
+#include <executionjournal.h>
+#include <QtCore/QThread>
+#include <metatypecache.h>
+#include <phonebotlogging.h>
+#include <rule.h>
+#include <ruledispatcher.h>
+#include <triggeringress.h>
 #include "adaptor.h"
+#include "engineworker.h"
 
 static const char *SERVICE = "org.SfietKonstantin.phonebot";
 static const char *ROOT = "/";
 
 static const char *RULE_FILE = "rule.qml";
+static const char *CONTINUATIONS_FILE = "continuations.json";
+static const char *WORKER_CONTINUATIONS_FILE = "continuations_%1.json";
+static const char *WORKERS_KEY = "workers";
+static const char *JOURNAL_FILE = "journal.bin";
+static const int JOURNAL_CAPACITY = 16384; // 512 KiB of records
 static const char *DIR_FORMAT = "rule_%1";
+static const int WATCHER_DEBOUNCE = 500;
+// Debug output is opt-in, and can be enabled at runtime through DBus
+static const char *DEFAULT_LOGGING_RULES = "phonebot.*.debug=false";
+
+struct RuleFileInfo
+{
+    bool operator==(const RuleFileInfo &other) const;
+    bool operator!=(const RuleFileInfo &other) const;
+    QDateTime lastModified;
+    qint64 size;
+};
+
+bool RuleFileInfo::operator==(const RuleFileInfo &other) const
+{
+    return lastModified == other.lastModified && size == other.size;
+}
+
+bool RuleFileInfo::operator!=(const RuleFileInfo &other) const
+{
+    return !(*this == other);
+}
 
 class EngineManagerPrivate
 {
 public:
     explicit EngineManagerPrivate(EngineManager *q);
     void slotComponentLoadingFinished(const QUrl &url, bool ok);
+    void slotStagingComponentLoadingFinished(const QUrl &url, bool ok);
+    void slotStagingRuleCreated(const QUrl &url);
+    void slotStagingReadyChanged();
+    void slotEngineReadyChanged();
+    void slotWorkerReadyChanged();
+    void slotWatchedPathChanged();
+    void slotRescan();
     bool registerToBus();
     void unregisterFromBus();
+    static QString configRoot();
+    static QString dataRoot();
+    static QSet<QString> existingDirs();
+    static bool createRuleFile(const QString &rule, QSet<QString> &dirs);
+    static bool removeRuleFile(const QString &path);
+    static bool editRuleFile(const QString &path, const QString &rule);
+    static QMap<QString, RuleFileInfo> scanRuleFiles();
+    void updateWatchedPaths();
+    MetaTypeCache * metaTypeCache();
+    bool addRule(PhoneBotEngine *target, const QUrl &url);
+    bool loadComponent(const QUrl &url);
+    PhoneBotEngine * createEngine();
+    void connectEngine(PhoneBotEngine *target, bool staging);
+    void startStaging();
+    void startStagedRules();
+    void deleteStaging();
+    void swapStaging();
+    void createWorkers();
+    void deleteWorkers();
+    EngineWorker * worker(const QString &rule) const;
+    QStringList ownRules() const;
     bool running;
     PhoneBotEngine *engine;
+    PhoneBotEngine *stagingEngine;
     QStringList rules;
     QSet<QUrl> loadingComponents;
+    QSet<QUrl> stagingComponents;
+    qint64 lastReloadOverlap;
+    QMap<QString, RuleFileInfo> ruleFiles;
+    QFileSystemWatcher *watcher;
+    QTimer *rescanTimer;
+    MetaTypeCache *typeCache;
+    int workerCount;
+    QList<QThread *> threads;
+    QList<EngineWorker *> workers;
+    QString loggingRules;
 protected:
     EngineManager * const q_ptr;
 private:
@@ -61,7 +138,9 @@ private:
 };
 
 EngineManagerPrivate::EngineManagerPrivate(EngineManager *q)
-    : running(false), engine(0), q_ptr(q)
+    : running(false), engine(0), stagingEngine(0), lastReloadOverlap(-1)
+    , watcher(0), rescanTimer(0), typeCache(0), workerCount(1)
+    , loggingRules(QLatin1String(DEFAULT_LOGGING_RULES)), q_ptr(q)
 {
 }
 
@@ -83,33 +162,467 @@ void EngineManagerPrivate::unregisterFromBus()
 }
 
 void EngineManagerPrivate::slotComponentLoadingFinished(const QUrl &url, bool ok)
+{
+    Q_Q(EngineManager);
+    // Components loaded as part of a full reload are started
+    // together, when the last one is loaded
+    if (loadingComponents.contains(url)) {
+        loadingComponents.remove(url);
+        if (loadingComponents.isEmpty()) {
+            engine->start();
+            running = true;
+            emit q->runningChanged();
+        }
+        return;
+    }
+
+    // Components loaded incrementally are started one by one
+    if (running && ok) {
+        engine->startComponent(url);
+    }
+}
+
+void EngineManagerPrivate::slotStagingComponentLoadingFinished(const QUrl &url, bool ok)
 {
     Q_UNUSED(ok)
+    if (!stagingComponents.contains(url)) {
+        return;
+    }
+
+    stagingComponents.remove(url);
+    if (stagingComponents.isEmpty()) {
+        startStagedRules();
+    }
+}
+
+void EngineManagerPrivate::slotStagingRuleCreated(const QUrl &url)
+{
+    // Each old rule is destroyed as soon as the new rule
+    // for the same file is live, so that there is no
+    // window where a rule is not handling triggers.
+    // Both rules are live from the completion of the new
+    // one, and an event fired during this overlap might be
+    // handled twice
+    Rule *stagedRule = stagingEngine->rule(url);
+    bool hibernated = engine->isHibernated(url);
+    engine->removeComponent(url);
+    if (stagedRule) {
+        lastReloadOverlap = qMax(lastReloadOverlap, stagedRule->liveTime());
+    }
+
+    // Rules that were disabled stay disabled
+    if (hibernated) {
+        stagingEngine->setRuleEnabled(url, false);
+    }
+}
+
+void EngineManagerPrivate::slotStagingReadyChanged()
+{
+    if (stagingEngine && stagingEngine->isReady()) {
+        swapStaging();
+    }
+}
+
+void EngineManagerPrivate::slotEngineReadyChanged()
+{
+    Q_Q(EngineManager);
+    // Plugins imported by the rules that were loaded
+    // through QML are now known, rebuild the type cache
+    if (engine->isReady() && typeCache) {
+        typeCache->deleteLater();
+        typeCache = 0;
+    }
+
+    // Continuations that were not claimed by any loaded rule are stale
+    if (engine->isReady()) {
+        ContinuationScheduler::instance()->discardUnbound();
+    }
+
+    emit q->readyChanged();
+    emit q->ReadyChanged(q->isReady());
+}
+
+void EngineManagerPrivate::slotWorkerReadyChanged()
+{
+    Q_Q(EngineManager);
+    emit q->readyChanged();
+    emit q->ReadyChanged(q->isReady());
+}
+
+void EngineManagerPrivate::slotWatchedPathChanged()
+{
+    // Writes usually come in bursts, so we wait for
+    // the config folder to settle before rescanning it
+    rescanTimer->start();
+}
+
+void EngineManagerPrivate::slotRescan()
+{
+    Q_Q(EngineManager);
+    // Wait for the staged rules to be swapped in
+    // before applying incremental changes
+    if (stagingEngine) {
+        rescanTimer->start();
+        return;
+    }
+
+    QMap<QString, RuleFileInfo> newRuleFiles = scanRuleFiles();
+    QStringList removed;
+    QStringList added;
+    QStringList modified;
+
+    for (QMap<QString, RuleFileInfo>::const_iterator it = ruleFiles.constBegin();
+         it != ruleFiles.constEnd(); ++it) {
+        if (!newRuleFiles.contains(it.key())) {
+            removed.append(it.key());
+        }
+    }
+
+    for (QMap<QString, RuleFileInfo>::const_iterator it = newRuleFiles.constBegin();
+         it != newRuleFiles.constEnd(); ++it) {
+        if (!ruleFiles.contains(it.key())) {
+            added.append(it.key());
+        } else if (ruleFiles.value(it.key()) != it.value()) {
+            modified.append(it.key());
+        }
+    }
 
-    // If it's empty, it means that stop has been called
-    // Don't try to launch engine
-    if (loadingComponents.isEmpty()) {
+    ruleFiles = newRuleFiles;
+    updateWatchedPaths();
+
+    if (removed.isEmpty() && added.isEmpty() && modified.isEmpty()) {
         return;
     }
 
-    loadingComponents.remove(url);
-    if (loadingComponents.isEmpty()) {
-        engine->start();
-        running = true;
+    QStringList oldRules = rules;
+    rules = ruleFiles.keys();
+
+    // If the engine is neither running nor loading, there is
+    // nothing to update, the next reload will pick the changes
+    if (running || !loadingComponents.isEmpty()) {
+        // A modified rule is replaced through a staged reload of its
+        // partition, so that the old rule keeps on handling triggers
+        // until the new one is live. The staged reload also picks the
+        // other changes of the partition.
+        bool restaged = false;
+        QSet<EngineWorker *> restagedWorkers;
+        for (const QString &rule : modified) {
+            EngineWorker *owner = worker(rule);
+            if (owner) {
+                restagedWorkers.insert(owner);
+            } else if (running) {
+                restaged = true;
+            }
+        }
+
+        for (const QString &rule : removed + modified) {
+            EngineWorker *owner = worker(rule);
+            if (owner ? restagedWorkers.contains(owner) : restaged) {
+                continue;
+            }
+
+            qCDebug(phonebotDaemon) << "Rule unloaded:" << rule;
+            if (owner) {
+                QMetaObject::invokeMethod(owner, "unloadRule", Qt::QueuedConnection,
+                                          Q_ARG(QString, rule));
+                continue;
+            }
+
+            QUrl source = QUrl::fromLocalFile(rule);
+            loadingComponents.remove(source);
+            engine->removeComponent(source);
+        }
+
+        for (const QString &rule : modified + added) {
+            EngineWorker *owner = worker(rule);
+            if (owner ? restagedWorkers.contains(owner) : restaged) {
+                continue;
+            }
+
+            qCDebug(phonebotDaemon) << "Rule loaded:" << rule;
+            if (owner) {
+                QMetaObject::invokeMethod(owner, "loadRule", Qt::QueuedConnection,
+                                          Q_ARG(QString, rule));
+                continue;
+            }
+            loadComponent(QUrl::fromLocalFile(rule));
+        }
+
+        for (EngineWorker *owner : restagedWorkers) {
+            QStringList partition;
+            for (const QString &rule : rules) {
+                if (worker(rule) == owner) {
+                    partition.append(rule);
+                }
+            }
+            qCDebug(phonebotDaemon) << "Rules staged in worker" << owner->index();
+            QMetaObject::invokeMethod(owner, "reload", Qt::QueuedConnection,
+                                      Q_ARG(QStringList, partition));
+        }
+
+        if (restaged) {
+            qCDebug(phonebotDaemon) << "Rules staged";
+            startStaging();
+        }
+    }
+
+    if (oldRules != rules) {
+        emit q->rulesChanged();
+    }
+}
+
+QMap<QString, RuleFileInfo> EngineManagerPrivate::scanRuleFiles()
+{
+    // We check every folder inside .config/<org>/<app>/
+    // and see if there is a "rule.qml" inside
+    QMap<QString, RuleFileInfo> ruleFiles;
+    QDir dir (configRoot());
+    for (const QString &subdirPath : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QDir subdir (dir);
+        if (!subdir.cd(subdirPath)) {
+            continue;
+        }
+        if (subdir.exists(RULE_FILE)) {
+            QFileInfo info (subdir.absoluteFilePath(RULE_FILE));
+            RuleFileInfo ruleFileInfo;
+            ruleFileInfo.lastModified = info.lastModified();
+            ruleFileInfo.size = info.size();
+            ruleFiles.insert(info.absoluteFilePath(), ruleFileInfo);
+        }
+    }
+    return ruleFiles;
+}
+
+void EngineManagerPrivate::updateWatchedPaths()
+{
+    // Folders are watched for created and removed rules,
+    // and rule files are watched for in-place modifications
+    QString root = configRoot();
+    QDir().mkpath(root);
+
+    QStringList paths;
+    paths.append(root);
+    QDir dir (root);
+    for (const QString &subdirPath : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        paths.append(dir.absoluteFilePath(subdirPath));
+    }
+    paths.append(ruleFiles.keys());
+
+    QSet<QString> watched = (watcher->directories() + watcher->files()).toSet();
+    QSet<QString> wanted = paths.toSet();
+    QStringList toRemove = (watched - wanted).toList();
+    QStringList toAdd = (wanted - watched).toList();
+    if (!toRemove.isEmpty()) {
+        watcher->removePaths(toRemove);
+    }
+    if (!toAdd.isEmpty()) {
+        watcher->addPaths(toAdd);
+    }
+}
+
+PhoneBotEngine * EngineManagerPrivate::createEngine()
+{
+    Q_Q(EngineManager);
+    return EngineWorker::createEngine(q);
+}
+
+void EngineManagerPrivate::connectEngine(PhoneBotEngine *target, bool staging)
+{
+    Q_Q(EngineManager);
+    target->disconnect(q);
+    if (staging) {
+        QObject::connect(target, SIGNAL(componentLoadingFinished(QUrl,bool)),
+                         q, SLOT(slotStagingComponentLoadingFinished(QUrl,bool)));
+        QObject::connect(target, SIGNAL(ruleCreated(QUrl)), q, SLOT(slotStagingRuleCreated(QUrl)));
+        QObject::connect(target, SIGNAL(readyChanged()), q, SLOT(slotStagingReadyChanged()));
+    } else {
+        QObject::connect(target, SIGNAL(componentLoadingFinished(QUrl,bool)),
+                         q, SLOT(slotComponentLoadingFinished(QUrl,bool)));
+        QObject::connect(target, SIGNAL(readyChanged()), q, SLOT(slotEngineReadyChanged()));
+    }
+    QObject::connect(target, SIGNAL(startProgress(int,int)), q, SIGNAL(StartProgress(int,int)));
+}
+
+void EngineManagerPrivate::startStaging()
+{
+    // The new set of rules is loaded in a second engine, while
+    // the rules in the current engine keep on handling triggers
+    deleteStaging();
+    stagingEngine = createEngine();
+    connectEngine(stagingEngine, true);
+
+    for (const QString &rule : ownRules()) {
+        QUrl source = QUrl::fromLocalFile(rule);
+        if (addRule(stagingEngine, source)) {
+            stagingComponents.insert(source);
+        }
+    }
+
+    if (stagingComponents.isEmpty()) {
+        startStagedRules();
+    }
+}
+
+void EngineManagerPrivate::startStagedRules()
+{
+    Q_Q(EngineManager);
+    for (const QString &rule : ownRules()) {
+        QUrl source = QUrl::fromLocalFile(rule);
+        stagingEngine->setNextTriggerHint(source, engine->nextTriggerHint(source));
+    }
+
+    lastReloadOverlap = 0;
+    emit q->readyChanged();
+    emit q->ReadyChanged(false);
+    stagingEngine->start();
+}
+
+void EngineManagerPrivate::deleteStaging()
+{
+    if (stagingEngine) {
+        stagingEngine->disconnect();
+        stagingEngine->clear();
+        stagingEngine->deleteLater();
+        stagingEngine = 0;
+    }
+    stagingComponents.clear();
+}
+
+void EngineManagerPrivate::swapStaging()
+{
+    Q_Q(EngineManager);
+    // Rules that were not replaced by a new
+    // one are the ones that got removed
+    engine->clear();
+
+    PhoneBotEngine *oldEngine = engine;
+    engine = stagingEngine;
+    stagingEngine = 0;
+    connectEngine(engine, false);
+    oldEngine->disconnect(q);
+    oldEngine->deleteLater();
+
+    qCDebug(phonebotDaemon) << "Rules swapped, longest overlap" << lastReloadOverlap << "us";
+    emit q->lastReloadOverlapChanged();
+    slotEngineReadyChanged();
+}
+
+void EngineManagerPrivate::createWorkers()
+{
+    Q_Q(EngineManager);
+    // The main engine is the first partition, each
+    // other partition is evaluated in its own thread
+    for (int i = 1; i < workerCount; ++i) {
+        QString continuationsPath = QDir(dataRoot()).absoluteFilePath(QString(WORKER_CONTINUATIONS_FILE).arg(i));
+        QThread *thread = new QThread(q);
+        EngineWorker *newWorker = new EngineWorker(i, continuationsPath);
+        newWorker->moveToThread(thread);
+        QObject::connect(thread, SIGNAL(finished()), newWorker, SLOT(deleteLater()));
+        QObject::connect(newWorker, SIGNAL(readyChanged()), q, SLOT(slotWorkerReadyChanged()),
+                         Qt::QueuedConnection);
+        thread->setObjectName(QString("phonebot-worker-%1").arg(i));
+        thread->start();
+        threads.append(thread);
+        workers.append(newWorker);
+    }
+}
+
+void EngineManagerPrivate::deleteWorkers()
+{
+    for (EngineWorker *oldWorker : workers) {
+        oldWorker->disconnect();
+        QMetaObject::invokeMethod(oldWorker, "stop", Qt::QueuedConnection);
+    }
+
+    for (QThread *thread : threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    threads.clear();
+    workers.clear();
+}
+
+EngineWorker * EngineManagerPrivate::worker(const QString &rule) const
+{
+    // Rules are partitioned with a hash that is stable across
+    // restarts, so that they keep their persisted continuations
+    if (workers.isEmpty()) {
+        return 0;
+    }
+
+    QByteArray path = rule.toUtf8();
+    int partition = qChecksum(path.constData(), path.size()) % workerCount;
+    return partition == 0 ? 0 : workers.at(partition - 1);
+}
+
+QStringList EngineManagerPrivate::ownRules() const
+{
+    QStringList own;
+    for (const QString &rule : rules) {
+        if (!worker(rule)) {
+            own.append(rule);
+        }
+    }
+    return own;
+}
+
+MetaTypeCache * EngineManagerPrivate::metaTypeCache()
+{
+    Q_Q(EngineManager);
+    if (!typeCache) {
+        typeCache = new MetaTypeCache(q);
+    }
+    return typeCache;
+}
+
+bool EngineManagerPrivate::addRule(PhoneBotEngine *target, const QUrl &url)
+{
+    return EngineWorker::addRule(target, url, metaTypeCache());
+}
+
+bool EngineManagerPrivate::loadComponent(const QUrl &url)
+{
+    if (!addRule(engine, url)) {
+        return false;
+    }
+
+    if (!running) {
+        loadingComponents.insert(url);
     }
+    return true;
 }
 
 EngineManager::EngineManager(QObject *parent)
     : QObject(parent), d_ptr(new EngineManagerPrivate(this))
 {
     Q_D(EngineManager);
-    d->engine = new PhoneBotEngine(this);
-    d->engine->registerTypes();
-    connect(d->engine, SIGNAL(componentLoadingFinished(QUrl,bool)),
-            this, SLOT(slotComponentLoadingFinished(QUrl,bool)));
+    PhoneBotEngine::registerTypes();
+    QLoggingCategory::setFilterRules(d->loggingRules);
+
+    // Executions are recorded for post-mortem analysis
+    QDir().mkpath(d->dataRoot());
+    ExecutionJournal::open(QDir(d->dataRoot()).absoluteFilePath(JOURNAL_FILE), JOURNAL_CAPACITY,
+                           d->scanRuleFiles().count());
+
+    // Pending delayed actions are persisted so that they survive restarts
+    ContinuationScheduler::instance()->setStoragePath(QDir(d->dataRoot()).absoluteFilePath(CONTINUATIONS_FILE));
+
+    d->engine = d->createEngine();
+    d->connectEngine(d->engine, false);
+
+    d->rescanTimer = new QTimer(this);
+    d->rescanTimer->setSingleShot(true);
+    d->rescanTimer->setInterval(WATCHER_DEBOUNCE);
+    connect(d->rescanTimer, SIGNAL(timeout()), this, SLOT(slotRescan()));
+
+    d->watcher = new QFileSystemWatcher(this);
+    connect(d->watcher, SIGNAL(directoryChanged(QString)), this, SLOT(slotWatchedPathChanged()));
+    connect(d->watcher, SIGNAL(fileChanged(QString)), this, SLOT(slotWatchedPathChanged()));
+
     new PhonebotAdaptor(this);
     if (!d->registerToBus()) {
-        qWarning() << "Failed to register to DBus. Maybe another daemon is running";
+        qCWarning(phonebotDaemon) << "Failed to register to DBus. Maybe another daemon is running";
     }
 }
 
@@ -117,7 +630,10 @@ EngineManager::~EngineManager()
 {
     Q_D(EngineManager);
     stop();
+    d->deleteWorkers();
     d->unregisterFromBus();
+    ContinuationScheduler::instance()->flush();
+    ExecutionJournal::close();
 }
 
 bool EngineManager::isRunning() const
@@ -132,6 +648,33 @@ QStringList EngineManager::rules() const
     return d->rules;
 }
 
+int EngineManager::workerCount() const
+{
+    Q_D(const EngineManager);
+    return d->workerCount;
+}
+
+void EngineManager::setWorkerCount(int workerCount)
+{
+    Q_D(EngineManager);
+    workerCount = qMax(workerCount, 1);
+    if (d->workerCount == workerCount) {
+        return;
+    }
+
+    // Rules are partitioned differently, so they are reloaded
+    bool wasRunning = d->running;
+    stop();
+    d->deleteWorkers();
+    d->workerCount = workerCount;
+    d->createWorkers();
+    emit workerCountChanged();
+
+    if (wasRunning) {
+        reloadEngine();
+    }
+}
+
 static QString generateDirName(int index)
 {
     QString indexStr = QString::number(index);
@@ -141,49 +684,61 @@ static QString generateDirName(int index)
     return QString(DIR_FORMAT).arg(number);
 }
 
-bool EngineManager::addRule(const QString &rule)
+QString EngineManagerPrivate::dataRoot()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+}
+
+QString EngineManagerPrivate::configRoot()
 {
     QString configRoot = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
     configRoot.append(QString("/%1/%2/").arg(QCoreApplication::instance()->organizationName(),
                                              QCoreApplication::instance()->applicationName()));
-    QDir dir (configRoot);
-    QStringList dirs = dir.entryList(QDir::Dirs);
-    QSet<QString> dirsSet = dirs.toSet();
+    return configRoot;
+}
+
+QSet<QString> EngineManagerPrivate::existingDirs()
+{
+    QDir dir (configRoot());
+    return dir.entryList(QDir::Dirs).toSet();
+}
 
+bool EngineManagerPrivate::createRuleFile(const QString &rule, QSet<QString> &dirs)
+{
+    QDir dir (configRoot());
     int index = 0;
     QString dirName = generateDirName(index);
-    while (dirsSet.contains(dirName)) {
+    while (dirs.contains(dirName)) {
         ++ index;
         dirName = generateDirName(index);
     }
 
     if (!dir.mkpath(dirName)) {
-        qWarning() << "Failed to create directory for new rule";
-        qWarning() << "Creating directory" << dirName << "in" << dir.absolutePath();
+        qCWarning(phonebotDaemon) << "Failed to create directory for new rule";
+        qCWarning(phonebotDaemon) << "Creating directory" << dirName << "in" << dir.absolutePath();
         return false;
     }
+    dirs.insert(dirName);
 
     if (!dir.cd(dirName)) {
-        qWarning() << "Failed to enter in created directory for new rule";
-        qWarning() << "Enter in" << dirName << "from" << dir.absolutePath();
+        qCWarning(phonebotDaemon) << "Failed to enter in created directory for new rule";
+        qCWarning(phonebotDaemon) << "Enter in" << dirName << "from" << dir.absolutePath();
         return false;
     }
 
     QFile file (dir.absoluteFilePath(RULE_FILE));
     if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file to write new rule";
-        qWarning() << "File:" << dir.absoluteFilePath(RULE_FILE);
+        qCWarning(phonebotDaemon) << "Failed to open file to write new rule";
+        qCWarning(phonebotDaemon) << "File:" << dir.absoluteFilePath(RULE_FILE);
         return false;
     }
 
     file.write(rule.toLocal8Bit());
     file.close();
-
-    reloadEngine();
     return true;
 }
 
-bool EngineManager::removeRule(const QString &path)
+bool EngineManagerPrivate::removeRuleFile(const QString &path)
 {
     QFileInfo info (path);
     if (!info.exists()) {
@@ -199,15 +754,13 @@ bool EngineManager::removeRule(const QString &path)
         return false;
     }
 
-    bool ok = true;
     if (folder.entryList(QDir::AllEntries | QDir::System |QDir::NoDotAndDotDot).isEmpty()) {
-        ok = folder.removeRecursively();
+        return folder.removeRecursively();
     }
-    reloadEngine();
-    return ok;
+    return true;
 }
 
-bool EngineManager::editRule(const QString &path, const QString &rule)
+bool EngineManagerPrivate::editRuleFile(const QString &path, const QString &rule)
 {
     QFileInfo info (path);
     if (!info.exists()) {
@@ -216,44 +769,141 @@ bool EngineManager::editRule(const QString &path, const QString &rule)
 
     QFile file (path);
     if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file to edit rule";
+        qCWarning(phonebotDaemon) << "Failed to open file to edit rule";
         return false;
     }
 
     file.write(rule.toLocal8Bit());
     file.close();
+    return true;
+}
+
+bool EngineManager::addRule(const QString &rule)
+{
+    Q_D(EngineManager);
+    QSet<QString> dirs = d->existingDirs();
+    if (!d->createRuleFile(rule, dirs)) {
+        return false;
+    }
+
+    reloadEngine();
+    return true;
+}
+
+bool EngineManager::removeRule(const QString &path)
+{
+    Q_D(EngineManager);
+    QFileInfo info (path);
+    if (!info.exists() || !info.isFile()) {
+        return false;
+    }
+
+    bool ok = d->removeRuleFile(path);
+    reloadEngine();
+    return ok;
+}
+
+bool EngineManager::editRule(const QString &path, const QString &rule)
+{
+    Q_D(EngineManager);
+    if (!d->editRuleFile(path, rule)) {
+        return false;
+    }
 
     reloadEngine();
     return true;
 }
 
+QList<bool> EngineManager::applyChanges(const QStringList &adds, const QStringList &editPaths,
+                                        const QStringList &editRules, const QStringList &removes)
+{
+    Q_D(EngineManager);
+    QList<bool> results;
+    if (editPaths.count() != editRules.count()) {
+        qCWarning(phonebotDaemon) << "Edited paths and edited rules do not have the same size";
+        return results;
+    }
+
+    // Every file is written first, and the engine is only
+    // reloaded once, after the whole batch is applied
+    QSet<QString> dirs = d->existingDirs();
+    for (const QString &rule : adds) {
+        results.append(d->createRuleFile(rule, dirs));
+    }
+
+    for (int i = 0; i < editPaths.count(); ++i) {
+        results.append(d->editRuleFile(editPaths.at(i), editRules.at(i)));
+    }
+
+    for (const QString &path : removes) {
+        results.append(d->removeRuleFile(path));
+    }
+
+    reloadEngine();
+    return results;
+}
+
+bool EngineManager::setRuleEnabled(const QString &path, bool enabled)
+{
+    Q_D(EngineManager);
+    // Rules in workers are updated asynchronously
+    EngineWorker *owner = d->worker(path);
+    if (owner) {
+        if (!d->rules.contains(path)) {
+            return false;
+        }
+        QMetaObject::invokeMethod(owner, "setRuleEnabled", Qt::QueuedConnection,
+                                  Q_ARG(QString, path), Q_ARG(bool, enabled));
+        return true;
+    }
+    return d->engine->setRuleEnabled(QUrl::fromLocalFile(path), enabled);
+}
+
 void EngineManager::reloadEngine()
 {
     Q_D(EngineManager);
-    stop();
+    d->rescanTimer->stop();
     QStringList rules = d->rules;
-    d->rules.clear();
 
-    // We check every folder inside .config/<org>/<app>/
-    // and see if there is a "rule.qml" inside
-    QString configRoot = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
-    configRoot.append(QString("/%1/%2/").arg(QCoreApplication::instance()->organizationName(),
-                                             QCoreApplication::instance()->applicationName()));
-    qDebug() << "Using" << configRoot << "to search rules";
-    QDir dir (configRoot);
-    for (const QString &subdirPath : dir.entryList(QDir::Dirs)) {
-        QDir subdir (dir);
-        if (!subdir.cd(subdirPath)) {
-            continue;
+    qCDebug(phonebotDaemon) << "Using" << d->configRoot() << "to search rules";
+    d->ruleFiles = d->scanRuleFiles();
+    d->rules = d->ruleFiles.keys();
+    d->updateWatchedPaths();
+
+    QMap<EngineWorker *, QStringList> partitions;
+    for (EngineWorker *worker : d->workers) {
+        partitions.insert(worker, QStringList());
+    }
+    for (const QString &rule : d->rules) {
+        EngineWorker *owner = d->worker(rule);
+        if (owner) {
+            partitions[owner].append(rule);
         }
-        if (subdir.exists(RULE_FILE)) {
-            QString rule = subdir.absoluteFilePath(RULE_FILE);
-            d->rules.append(rule);
-            QUrl source = QUrl::fromLocalFile(rule);
-            qDebug() << "Rule found:" << rule;
-            if (d->engine->addComponent(QUrl::fromLocalFile(rule))) {
-                d->loadingComponents.insert(source);
-            }
+    }
+    for (QMap<EngineWorker *, QStringList>::const_iterator it = partitions.constBegin();
+         it != partitions.constEnd(); ++it) {
+        QMetaObject::invokeMethod(it.key(), "reload", Qt::QueuedConnection,
+                                  Q_ARG(QStringList, it.value()));
+    }
+
+    if (d->running) {
+        // Running rules are only replaced when the new ones are ready
+        d->startStaging();
+    } else {
+        // Previously loaded components are dropped, so
+        // that modified rules are parsed again
+        d->loadingComponents.clear();
+        d->engine->clear();
+        for (const QString &rule : d->ownRules()) {
+            qCDebug(phonebotDaemon) << "Rule found:" << rule;
+            d->loadComponent(QUrl::fromLocalFile(rule));
+        }
+
+        // Nothing to wait for if no rule was loaded in this engine
+        if (d->loadingComponents.isEmpty()) {
+            d->engine->start();
+            d->running = true;
+            emit runningChanged();
         }
     }
 
@@ -262,9 +912,27 @@ void EngineManager::reloadEngine()
     }
 }
 
+bool EngineManager::isReady() const
+{
+    Q_D(const EngineManager);
+    for (EngineWorker *worker : d->workers) {
+        if (!worker->isReady()) {
+            return false;
+        }
+    }
+    return d->running && !d->stagingEngine && d->engine->isReady();
+}
+
+qint64 EngineManager::lastReloadOverlap() const
+{
+    Q_D(const EngineManager);
+    return d->lastReloadOverlap;
+}
+
 void EngineManager::stop()
 {
     Q_D(EngineManager);
+    d->deleteStaging();
     if (d->running) {
         if (!d->loadingComponents.isEmpty()) {
             d->loadingComponents.clear();
@@ -274,6 +942,10 @@ void EngineManager::stop()
         d->running = false;
         emit runningChanged();
     }
+
+    for (EngineWorker *worker : d->workers) {
+        QMetaObject::invokeMethod(worker, "stop", Qt::QueuedConnection);
+    }
 }
 
 bool EngineManager::IsRunning() const
@@ -286,6 +958,58 @@ QStringList EngineManager::Rules() const
     return rules();
 }
 
+bool EngineManager::IsReady() const
+{
+    return isReady();
+}
+
+qlonglong EngineManager::LastReloadOverlap() const
+{
+    return lastReloadOverlap();
+}
+
+QVariantMap EngineManager::DispatchMetrics() const
+{
+    Q_D(const EngineManager);
+    QVariantMap metrics;
+    if (!d->engine || !d->engine->dispatcher()) {
+        return metrics;
+    }
+
+    RuleDispatcher *dispatcher = d->engine->dispatcher();
+    metrics.insert("depth", dispatcher->depth());
+    metrics.insert("droppedCount", dispatcher->droppedCount());
+    metrics.insert("coalescedCount", dispatcher->coalescedCount());
+    metrics.insert("lastQueueWait", dispatcher->lastQueueWait());
+    metrics.insert("maxQueueWait", dispatcher->maxQueueWait());
+    metrics.insert("averageQueueWait", dispatcher->averageQueueWait());
+    metrics.insert("ingressDrainedCount", TriggerIngress::instance()->drainedCount());
+    metrics.insert("ingressOverflowCount", TriggerIngress::instance()->overflowCount());
+
+    QVariantList workerMetrics;
+    for (EngineWorker *worker : d->workers) {
+        workerMetrics.append(worker->metrics());
+    }
+    if (!workerMetrics.isEmpty()) {
+        metrics.insert(WORKERS_KEY, workerMetrics);
+    }
+    return metrics;
+}
+
+QString EngineManager::LoggingRules() const
+{
+    Q_D(const EngineManager);
+    return d->loggingRules;
+}
+
+void EngineManager::SetLoggingRules(const QString &rules)
+{
+    Q_D(EngineManager);
+    // Filter rules are process wide, so they also apply to the worker engines
+    d->loggingRules = rules;
+    QLoggingCategory::setFilterRules(rules);
+}
+
 void EngineManager::ReloadEngine()
 {
     return reloadEngine();
@@ -311,4 +1035,15 @@ bool EngineManager::EditRule(const QString &path, const QString &rule)
     return editRule(path, rule);
 }
 
+bool EngineManager::SetRuleEnabled(const QString &path, bool enabled)
+{
+    return setRuleEnabled(path, enabled);
+}
+
+QList<bool> EngineManager::ApplyChanges(const QStringList &adds, const QStringList &editPaths,
+                                        const QStringList &editRules, const QStringList &removes)
+{
+    return applyChanges(adds, editPaths, editRules, removes);
+}
+
 #include "moc_enginemanager.cpp"
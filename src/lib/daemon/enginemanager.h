@@ -34,6 +34,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QSet>
+#include <QtCore/QVariantMap>
 #include <phonebotengine.h>
 
 class EngineManagerPrivate;
@@ -41,33 +42,64 @@ class EngineManager : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
     Q_PROPERTY(QStringList rules READ rules NOTIFY rulesChanged)
+    Q_PROPERTY(qint64 lastReloadOverlap READ lastReloadOverlap NOTIFY lastReloadOverlapChanged)
+    Q_PROPERTY(int workerCount READ workerCount WRITE setWorkerCount NOTIFY workerCountChanged)
 public:
     explicit EngineManager(QObject *parent = 0);
     virtual ~EngineManager();
     bool isRunning() const;
+    bool isReady() const;
     QStringList rules() const;
+    qint64 lastReloadOverlap() const; // In usecs
+    int workerCount() const;
+    void setWorkerCount(int workerCount);
     bool addRule(const QString &rule);
     bool removeRule(const QString &path);
     bool editRule(const QString &path, const QString &rule);
+    QList<bool> applyChanges(const QStringList &adds, const QStringList &editPaths,
+                             const QStringList &editRules, const QStringList &removes);
+    bool setRuleEnabled(const QString &path, bool enabled);
 public Q_SLOTS:
     void reloadEngine();
     void stop();
 Q_SIGNALS:
     void runningChanged();
+    void readyChanged();
     void rulesChanged();
+    void lastReloadOverlapChanged();
+    void workerCountChanged();
 public Q_SLOTS: // For DBus
     bool IsRunning() const;
+    bool IsReady() const;
     QStringList Rules() const;
+    qlonglong LastReloadOverlap() const;
+    QVariantMap DispatchMetrics() const;
+    QString LoggingRules() const;
+    void SetLoggingRules(const QString &rules);
     void ReloadEngine();
     void Stop();
     bool AddRule(const QString &rule);
     bool RemoveRule(const QString &path);
     bool EditRule(const QString &path, const QString &rule);
+    QList<bool> ApplyChanges(const QStringList &adds, const QStringList &editPaths,
+                             const QStringList &editRules, const QStringList &removes);
+    bool SetRuleEnabled(const QString &path, bool enabled);
+Q_SIGNALS: // For DBus
+    void ReadyChanged(bool ready);
+    void StartProgress(int created, int total);
 protected:
     QScopedPointer<EngineManagerPrivate> d_ptr;
 private:
     Q_PRIVATE_SLOT(d_func(), void slotComponentLoadingFinished(const QUrl &url, bool ok))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingComponentLoadingFinished(const QUrl &url, bool ok))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingRuleCreated(const QUrl &url))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingReadyChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotEngineReadyChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotWorkerReadyChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotWatchedPathChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotRescan())
     Q_DECLARE_PRIVATE(EngineManager)
 };
 
@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "engineworker.h"
+#include <QtCore/QDebug>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <continuationscheduler.h>
+#include <metatypecache.h>
+#include <nativerulefactory.h>
+#include <phonebotengine.h>
+#include <ruledispatcher.h>
+#include <triggeringress.h>
+
+static const int INCUBATION_BUDGET = 5; // 5 msecs per slice
+static const int DISPATCH_MAX_DEPTH = 64;
+
+static const char *INDEX_KEY = "index";
+static const char *RULES_KEY = "rules";
+static const char *READY_KEY = "ready";
+static const char *DEPTH_KEY = "depth";
+static const char *DROPPED_KEY = "droppedCount";
+static const char *COALESCED_KEY = "coalescedCount";
+static const char *LAST_WAIT_KEY = "lastQueueWait";
+static const char *MAX_WAIT_KEY = "maxQueueWait";
+static const char *AVERAGE_WAIT_KEY = "averageQueueWait";
+static const char *INGRESS_DRAINED_KEY = "ingressDrainedCount";
+static const char *INGRESS_OVERFLOW_KEY = "ingressOverflowCount";
+
+class EngineWorkerPrivate
+{
+public:
+    explicit EngineWorkerPrivate(EngineWorker *q);
+    void slotComponentLoadingFinished(const QUrl &url, bool ok);
+    void slotStagingComponentLoadingFinished(const QUrl &url, bool ok);
+    void slotStagingRuleCreated(const QUrl &url);
+    void slotStagingReadyChanged();
+    void slotEngineReadyChanged();
+    void slotUpdateMetrics();
+    PhoneBotEngine * ensureEngine();
+    MetaTypeCache * metaTypeCache();
+    void connectEngine(PhoneBotEngine *target, bool staging);
+    void startStagedRules();
+    void deleteStaging();
+    void swapStaging();
+    void setRunning(bool running);
+    int index;
+    QString continuationsPath;
+    PhoneBotEngine *engine;
+    PhoneBotEngine *stagingEngine;
+    MetaTypeCache *typeCache;
+    QSet<QUrl> rules;
+    QSet<QUrl> loadingComponents;
+    QSet<QUrl> stagingComponents;
+    bool stagingStarted;
+    bool running;
+    // Read from the router thread
+    mutable QMutex mutex;
+    bool ready;
+    QVariantMap metrics;
+protected:
+    EngineWorker * const q_ptr;
+private:
+    Q_DECLARE_PUBLIC(EngineWorker)
+};
+
+EngineWorkerPrivate::EngineWorkerPrivate(EngineWorker *q)
+    : index(0), engine(0), stagingEngine(0), typeCache(0), stagingStarted(false), running(false)
+    , ready(false), q_ptr(q)
+{
+}
+
+void EngineWorkerPrivate::slotComponentLoadingFinished(const QUrl &url, bool ok)
+{
+    // Same as the main engine, a full reload is started at once
+    // and incrementally loaded rules are started one by one
+    if (loadingComponents.contains(url)) {
+        loadingComponents.remove(url);
+        if (loadingComponents.isEmpty()) {
+            engine->start();
+            setRunning(true);
+        }
+        return;
+    }
+
+    if (running && ok) {
+        engine->startComponent(url);
+    }
+}
+
+void EngineWorkerPrivate::slotStagingComponentLoadingFinished(const QUrl &url, bool ok)
+{
+    // Rules loaded while the staged rules are being
+    // created are started one by one, like in the engine
+    if (stagingComponents.contains(url)) {
+        stagingComponents.remove(url);
+        if (stagingComponents.isEmpty() && !stagingStarted) {
+            startStagedRules();
+        }
+        return;
+    }
+
+    if (stagingStarted && ok) {
+        stagingEngine->startComponent(url);
+    }
+}
+
+void EngineWorkerPrivate::slotStagingRuleCreated(const QUrl &url)
+{
+    // Same as the main engine, the old rule is only
+    // destroyed once the new one is live
+    bool hibernated = engine->isHibernated(url);
+    engine->removeComponent(url);
+    if (hibernated) {
+        stagingEngine->setRuleEnabled(url, false);
+    }
+}
+
+void EngineWorkerPrivate::slotStagingReadyChanged()
+{
+    if (stagingEngine && stagingEngine->isReady()) {
+        swapStaging();
+    }
+}
+
+void EngineWorkerPrivate::slotEngineReadyChanged()
+{
+    if (engine->isReady() && typeCache) {
+        typeCache->deleteLater();
+        typeCache = 0;
+    }
+
+    if (engine->isReady()) {
+        ContinuationScheduler::instance()->discardUnbound();
+    }
+    setRunning(running);
+}
+
+void EngineWorkerPrivate::slotUpdateMetrics()
+{
+    Q_Q(EngineWorker);
+    QVariantMap newMetrics;
+    newMetrics.insert(INDEX_KEY, index);
+    newMetrics.insert(RULES_KEY, rules.count());
+    newMetrics.insert(READY_KEY, running && engine && engine->isReady());
+
+    RuleDispatcher *dispatcher = engine ? engine->dispatcher() : 0;
+    if (dispatcher) {
+        newMetrics.insert(DEPTH_KEY, dispatcher->depth());
+        newMetrics.insert(DROPPED_KEY, dispatcher->droppedCount());
+        newMetrics.insert(COALESCED_KEY, dispatcher->coalescedCount());
+        newMetrics.insert(LAST_WAIT_KEY, dispatcher->lastQueueWait());
+        newMetrics.insert(MAX_WAIT_KEY, dispatcher->maxQueueWait());
+        newMetrics.insert(AVERAGE_WAIT_KEY, dispatcher->averageQueueWait());
+    }
+    newMetrics.insert(INGRESS_DRAINED_KEY, TriggerIngress::instance()->drainedCount());
+    newMetrics.insert(INGRESS_OVERFLOW_KEY, TriggerIngress::instance()->overflowCount());
+
+    {
+        QMutexLocker locker (&mutex);
+        metrics = newMetrics;
+    }
+    emit q->metricsChanged();
+}
+
+PhoneBotEngine * EngineWorkerPrivate::ensureEngine()
+{
+    Q_Q(EngineWorker);
+    // The engine is created from the worker thread, so that
+    // the rules and their triggers live in that thread
+    if (engine) {
+        return engine;
+    }
+
+    ContinuationScheduler::instance()->setStoragePath(continuationsPath);
+    engine = EngineWorker::createEngine(q);
+    connectEngine(engine, false);
+    return engine;
+}
+
+void EngineWorkerPrivate::connectEngine(PhoneBotEngine *target, bool staging)
+{
+    Q_Q(EngineWorker);
+    target->disconnect(q);
+    if (staging) {
+        QObject::connect(target, SIGNAL(componentLoadingFinished(QUrl,bool)),
+                         q, SLOT(slotStagingComponentLoadingFinished(QUrl,bool)));
+        QObject::connect(target, SIGNAL(ruleCreated(QUrl)), q, SLOT(slotStagingRuleCreated(QUrl)));
+        QObject::connect(target, SIGNAL(readyChanged()), q, SLOT(slotStagingReadyChanged()));
+    } else {
+        QObject::connect(target, SIGNAL(componentLoadingFinished(QUrl,bool)),
+                         q, SLOT(slotComponentLoadingFinished(QUrl,bool)));
+        QObject::connect(target, SIGNAL(readyChanged()), q, SLOT(slotEngineReadyChanged()));
+        QObject::connect(target->dispatcher(), SIGNAL(metricsChanged()), q, SLOT(slotUpdateMetrics()));
+    }
+}
+
+void EngineWorkerPrivate::startStagedRules()
+{
+    stagingStarted = true;
+    for (const QUrl &source : rules) {
+        stagingEngine->setNextTriggerHint(source, engine->nextTriggerHint(source));
+    }
+    stagingEngine->start();
+}
+
+void EngineWorkerPrivate::deleteStaging()
+{
+    if (stagingEngine) {
+        stagingEngine->disconnect();
+        stagingEngine->clear();
+        stagingEngine->deleteLater();
+        stagingEngine = 0;
+    }
+    stagingComponents.clear();
+    stagingStarted = false;
+}
+
+void EngineWorkerPrivate::swapStaging()
+{
+    Q_Q(EngineWorker);
+    // Rules that were not replaced by a new
+    // one are the ones that got removed
+    engine->clear();
+
+    PhoneBotEngine *oldEngine = engine;
+    engine = stagingEngine;
+    stagingEngine = 0;
+    stagingComponents.clear();
+    stagingStarted = false;
+    connectEngine(engine, false);
+    oldEngine->disconnect(q);
+    oldEngine->dispatcher()->disconnect(q);
+    oldEngine->deleteLater();
+    slotEngineReadyChanged();
+}
+
+MetaTypeCache * EngineWorkerPrivate::metaTypeCache()
+{
+    Q_Q(EngineWorker);
+    if (!typeCache) {
+        typeCache = new MetaTypeCache(q);
+    }
+    return typeCache;
+}
+
+void EngineWorkerPrivate::setRunning(bool newRunning)
+{
+    Q_Q(EngineWorker);
+    running = newRunning;
+    bool newReady = running && engine && engine->isReady();
+    bool changed = false;
+    {
+        QMutexLocker locker (&mutex);
+        changed = (ready != newReady);
+        ready = newReady;
+    }
+
+    slotUpdateMetrics();
+    if (changed) {
+        emit q->readyChanged();
+    }
+}
+
+EngineWorker::EngineWorker(int index, const QString &continuationsPath, QObject *parent)
+    : QObject(parent), d_ptr(new EngineWorkerPrivate(this))
+{
+    Q_D(EngineWorker);
+    d->index = index;
+    d->continuationsPath = continuationsPath;
+}
+
+EngineWorker::~EngineWorker()
+{
+}
+
+int EngineWorker::index() const
+{
+    Q_D(const EngineWorker);
+    return d->index;
+}
+
+bool EngineWorker::isReady() const
+{
+    Q_D(const EngineWorker);
+    QMutexLocker locker (&d->mutex);
+    return d->ready;
+}
+
+QVariantMap EngineWorker::metrics() const
+{
+    Q_D(const EngineWorker);
+    QMutexLocker locker (&d->mutex);
+    return d->metrics;
+}
+
+PhoneBotEngine * EngineWorker::createEngine(QObject *parent)
+{
+    PhoneBotEngine *newEngine = new PhoneBotEngine(parent);
+    newEngine->setIncubationBudget(INCUBATION_BUDGET);
+    newEngine->setDispatchEnabled(true);
+    newEngine->dispatcher()->setMaxDepth(DISPATCH_MAX_DEPTH);
+    newEngine->dispatcher()->setOverloadPolicy(RuleDispatcher::CoalescePerRule);
+    return newEngine;
+}
+
+bool EngineWorker::addRule(PhoneBotEngine *target, const QUrl &url, MetaTypeCache *typeCache)
+{
+    // Purely declarative rules are built natively, skipping
+    // the QML compiler, others are loaded as components
+    QmlDocument::Ptr document = QmlDocument::create(url.toLocalFile());
+    if (document->error() == QmlDocument::NoError) {
+        NativeRuleFactory *factory = NativeRuleFactory::fromDocument(document, typeCache);
+        if (factory) {
+            return target->addFactory(url, factory);
+        }
+    }
+    return target->addComponent(url);
+}
+
+void EngineWorker::reload(const QStringList &rules)
+{
+    Q_D(EngineWorker);
+    PhoneBotEngine *engine = d->ensureEngine();
+    d->deleteStaging();
+    d->rules.clear();
+
+    // Running rules are only replaced when the new ones are
+    // ready, like in the main engine, so that no trigger is lost
+    if (d->running) {
+        d->stagingEngine = createEngine(this);
+        d->connectEngine(d->stagingEngine, true);
+        for (const QString &rule : rules) {
+            QUrl source = QUrl::fromLocalFile(rule);
+            d->rules.insert(source);
+            if (addRule(d->stagingEngine, source, d->metaTypeCache())) {
+                d->stagingComponents.insert(source);
+            }
+        }
+
+        if (d->stagingComponents.isEmpty()) {
+            d->startStagedRules();
+        }
+        return;
+    }
+
+    d->loadingComponents.clear();
+    engine->clear();
+    d->setRunning(false);
+
+    for (const QString &rule : rules) {
+        QUrl source = QUrl::fromLocalFile(rule);
+        d->rules.insert(source);
+        if (addRule(engine, source, d->metaTypeCache())) {
+            d->loadingComponents.insert(source);
+        }
+    }
+
+    if (d->loadingComponents.isEmpty()) {
+        engine->start();
+        d->setRunning(true);
+    }
+}
+
+void EngineWorker::loadRule(const QString &rule)
+{
+    Q_D(EngineWorker);
+    QUrl source = QUrl::fromLocalFile(rule);
+    d->rules.insert(source);
+    if (d->stagingEngine) {
+        if (addRule(d->stagingEngine, source, d->metaTypeCache()) && !d->stagingStarted) {
+            d->stagingComponents.insert(source);
+        }
+        return;
+    }
+
+    if (addRule(d->ensureEngine(), source, d->metaTypeCache()) && !d->running) {
+        d->loadingComponents.insert(source);
+    }
+}
+
+void EngineWorker::unloadRule(const QString &rule)
+{
+    Q_D(EngineWorker);
+    QUrl source = QUrl::fromLocalFile(rule);
+    d->rules.remove(source);
+    d->loadingComponents.remove(source);
+    d->ensureEngine()->removeComponent(source);
+    if (d->stagingEngine) {
+        d->stagingComponents.remove(source);
+        d->stagingEngine->removeComponent(source);
+        if (d->stagingComponents.isEmpty() && !d->stagingStarted) {
+            d->startStagedRules();
+        }
+    }
+    d->slotUpdateMetrics();
+}
+
+void EngineWorker::setRuleEnabled(const QString &rule, bool enabled)
+{
+    Q_D(EngineWorker);
+    // The old rule hands its state over when the staged one is created
+    QUrl source = QUrl::fromLocalFile(rule);
+    d->ensureEngine()->setRuleEnabled(source, enabled);
+    if (d->stagingEngine) {
+        d->stagingEngine->setRuleEnabled(source, enabled);
+    }
+}
+
+void EngineWorker::stop()
+{
+    Q_D(EngineWorker);
+    d->loadingComponents.clear();
+    d->deleteStaging();
+    if (d->engine) {
+        d->engine->stop();
+    }
+    d->setRunning(false);
+}
+
+#include "moc_engineworker.cpp"
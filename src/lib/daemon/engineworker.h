@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#ifndef ENGINEWORKER_H
+#define ENGINEWORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+class QUrl;
+class MetaTypeCache;
+class PhoneBotEngine;
+class EngineWorkerPrivate;
+class EngineWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EngineWorker(int index, const QString &continuationsPath, QObject *parent = 0);
+    virtual ~EngineWorker();
+    int index() const;
+    bool isReady() const;
+    QVariantMap metrics() const;
+    static PhoneBotEngine * createEngine(QObject *parent);
+    static bool addRule(PhoneBotEngine *target, const QUrl &url, MetaTypeCache *typeCache);
+public Q_SLOTS:
+    void reload(const QStringList &rules);
+    void loadRule(const QString &rule);
+    void unloadRule(const QString &rule);
+    void setRuleEnabled(const QString &rule, bool enabled);
+    void stop();
+Q_SIGNALS:
+    void readyChanged();
+    void metricsChanged();
+protected:
+    QScopedPointer<EngineWorkerPrivate> d_ptr;
+private:
+    Q_DECLARE_PRIVATE(EngineWorker)
+    Q_PRIVATE_SLOT(d_func(), void slotComponentLoadingFinished(const QUrl &url, bool ok))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingComponentLoadingFinished(const QUrl &url, bool ok))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingRuleCreated(const QUrl &url))
+    Q_PRIVATE_SLOT(d_func(), void slotStagingReadyChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotEngineReadyChanged())
+    Q_PRIVATE_SLOT(d_func(), void slotUpdateMetrics())
+};
+
+#endif // ENGINEWORKER_H
@@ -51,11 +51,12 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     Q_INVOKABLE QString nameFromValue(const QString &value) const;
-Q_SIGNALS:
-    void countChanged();
-public Q_SLOTS:
+    // Not invokable from QML, as choice models are shared
+    // between every component of a given type
     void addEntry(const QString &name, const QString &value);
     void clear();
+Q_SIGNALS:
+    void countChanged();
 protected:
     explicit ChoiceModel(ChoiceModelPrivate &dd, QObject *parent = 0);
     const QScopedPointer<ChoiceModelPrivate> d_ptr;
@@ -20,11 +20,13 @@ HEADERS += \
     qmldocument.h \
     metatypecache.h \
     choicemodel.h \
-    choicemodel_p.h
+    choicemodel_p.h \
+    nativerulefactory.h
 
 SOURCES += \
     abstractmetadata.cpp \
     metaproperty.cpp \
     qmldocument.cpp \
     metatypecache.cpp \
-    choicemodel.cpp
+    choicemodel.cpp \
+    nativerulefactory.cpp
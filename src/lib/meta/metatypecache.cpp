@@ -35,6 +35,7 @@
 #include <QtCore/QGlobalStatic>
 #include <QtCore/QMetaClassInfo>
 #include <QtCore/QMetaType>
+#include <QtCore/QThreadStorage>
 #include <QtQml/private/qqmlmetatype_p.h>
 
 static const char *TRIGGER_META = "Trigger";
@@ -42,9 +43,16 @@ static const char *CONDITION_META = "Condition";
 static const char *ACTION_META = "Action";
 static const char *JSCONDITION_META  ="JsCondition";
 static const char *JSACTION_META  ="JsAction";
+static const char *LAZYACTION_META  ="LazyAction";
+static const char *SEQUENCEACTION_META  ="SequenceAction";
+static const char *DELAYACTION_META  ="DelayAction";
 
 static const char *NO_METADATA_MACRO = "NO_METADATA";
 
+// Metadata are QObjects, that are lazily populated,
+// so each thread gets its own shared cache
+static QThreadStorage<MetaTypeCache *> caches;
+
 struct SortingMetaDataInfo
 {
     SortingMetaDataInfo(const QString &type, AbstractMetaData *metaData)
@@ -57,7 +65,9 @@ struct SortingMetaDataInfo
 
 static bool isFilteredOut(const QByteArray &className)
 {
-    if (className == JSCONDITION_META || className == JSACTION_META || className == TRIGGER_META) {
+    if (className == JSCONDITION_META || className == JSACTION_META || className == TRIGGER_META
+        || className == LAZYACTION_META || className == SEQUENCEACTION_META
+        || className == DELAYACTION_META) {
         return true;
     }
 
@@ -328,6 +338,14 @@ MetaTypeCache::~MetaTypeCache()
     qDeleteAll(d->metaCache);
 }
 
+MetaTypeCache * MetaTypeCache::instance()
+{
+    if (!caches.hasLocalData()) {
+        caches.setLocalData(new MetaTypeCache());
+    }
+    return caches.localData();
+}
+
 bool MetaTypeCache::exists(const QString &type) const
 {
     Q_D(const MetaTypeCache);
@@ -38,6 +38,16 @@
 class AbstractMetaData;
 class QMetaObject;
 class MetaTypeCachePrivate;
+
+// Type information about the components available in QML
+//
+// Building the cache scans every registered QML type, and creates the
+// metadata of each component, with its property descriptors and choice
+// lists. instance() provides a cache shared by every user in a thread,
+// so that descriptors are built once per component type, and can be
+// referenced by models instead of being duplicated. As the cache is
+// populated when created, it should only be used once every QML type
+// is registered.
 class MetaTypeCache : public QObject
 {
     Q_OBJECT
@@ -50,6 +60,7 @@ public:
     };
     explicit MetaTypeCache(QObject *parent = 0);
     virtual ~MetaTypeCache();
+    static MetaTypeCache * instance();
     bool exists(const QString &type) const;
     AbstractMetaData * metaData(const QString &type) const;
     const QMetaObject * metaObject(const QString &type) const;
@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "nativerulefactory.h"
+#include "metatypecache.h"
+#include <QtCore/QDebug>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QTime>
+#include <QtQml/private/qqmlmetatype_p.h>
+#include <rule.h>
+#include <trigger.h>
+#include <condition.h>
+#include <lazyaction.h>
+
+static const char *RULE_TYPE = "Rule";
+static const char *LAZYACTION_TYPE = "LazyAction";
+static const char *TIMEMAPPER_TYPE = "TimeMapper";
+static const char *MAPPER_VALUE = "value";
+
+typedef QMap<QString, QQmlType *> TypeMap;
+typedef QMap<QString, QTime> TimeMap;
+
+static bool inherits(const QMetaObject *metaObject, const QMetaObject *base)
+{
+    const QMetaObject *super = metaObject;
+    while (super) {
+        if (super == base) {
+            return true;
+        }
+        super = super->superClass();
+    }
+    return false;
+}
+
+// Resolve a mapper reference, or return an invalid QVariant if the
+// reference is not bound to a known TimeMapper
+static QVariant resolveReference(Reference::Ptr reference, const TimeMap &times)
+{
+    const QString &identifier = reference->identifier();
+    if (!times.contains(identifier)
+        || reference->value() != QString("%1.%2").arg(identifier, MAPPER_VALUE)) {
+        return QVariant();
+    }
+    return QVariant(times.value(identifier));
+}
+
+static QObject * createComponent(QmlObject::Ptr object, const TypeMap &types, const TimeMap &times,
+                                 QString *errorString = 0)
+{
+    QQmlType *type = types.value(object->type());
+    Q_ASSERT(type);
+    QObject *component = type->create();
+    if (!component) {
+        return 0;
+    }
+
+    QQmlParserStatus *parserStatus = qobject_cast<QQmlParserStatus *>(component);
+    if (parserStatus) {
+        parserStatus->classBegin();
+    }
+
+    for (const QString &key : object->properties()) {
+        QVariant value = object->property(key);
+        if (value.canConvert<Reference::Ptr>()) {
+            value = resolveReference(value.value<Reference::Ptr>(), times);
+        }
+        // The QML engine fails the component when a property cannot
+        // be set, and so does the factory, for the rule to behave the same
+        if (!component->setProperty(key.toLocal8Bit().constData(), value)) {
+            if (errorString) {
+                *errorString = QString("Cannot set property %1 of %2").arg(key, object->type());
+            }
+            delete component;
+            return 0;
+        }
+    }
+
+    if (parserStatus) {
+        parserStatus->componentComplete();
+    }
+    return component;
+}
+
+static QString creationError(const QString &kind, const QString &type, const QString &reason)
+{
+    QString error = QString("Failed to create %1 %2").arg(kind, type);
+    return reason.isEmpty() ? error : QString("%1. %2").arg(error, reason);
+}
+
+class NativeRuleFactoryPrivate
+{
+public:
+    explicit NativeRuleFactoryPrivate();
+    bool prepareMappers(const QVariant &mappers);
+    bool prepareComponent(QmlObject::Ptr object, const QMetaObject *base);
+    bool prepareAction(const QVariant &value);
+    QmlObject::Ptr root;
+    MetaTypeCache *cache;
+    TypeMap types;
+    TimeMap times;
+    QString errorString;
+};
+
+NativeRuleFactoryPrivate::NativeRuleFactoryPrivate()
+    : cache(0)
+{
+}
+
+bool NativeRuleFactoryPrivate::prepareMappers(const QVariant &mappers)
+{
+    for (const QVariant &mapperVariant : mappers.toList()) {
+        QmlObject::Ptr mapper = mapperVariant.value<QmlObject::Ptr>();
+        if (mapper.isNull() || mapper->type() != TIMEMAPPER_TYPE || mapper->id().isEmpty()
+            || !mapper->children().isEmpty()) {
+            return false;
+        }
+
+        QVariant hour = mapper->property("hour");
+        QVariant minute = mapper->property("minute");
+        if (hour.type() != QVariant::Double || minute.type() != QVariant::Double) {
+            return false;
+        }
+
+        QTime time (hour.toInt(), minute.toInt());
+        if (!time.isValid()) {
+            return false;
+        }
+        times.insert(mapper->id(), time);
+    }
+    return true;
+}
+
+bool NativeRuleFactoryPrivate::prepareComponent(QmlObject::Ptr object, const QMetaObject *base)
+{
+    if (object.isNull() || !object->children().isEmpty()) {
+        return false;
+    }
+
+    const QString &typeName = object->type();
+    const QMetaObject *metaObject = cache->metaObject(typeName);
+    if (!metaObject || !inherits(metaObject, base)) {
+        return false;
+    }
+
+    QQmlType *type = QQmlMetaType::qmlType(metaObject);
+    if (!type || !type->isCreatable()) {
+        return false;
+    }
+
+    for (const QString &key : object->properties()) {
+        int index = metaObject->indexOfProperty(key.toLocal8Bit().constData());
+        if (index == -1 || !metaObject->property(index).isWritable()) {
+            return false;
+        }
+
+        // Literals that don't convert to the type of the property are
+        // left to the QML engine, that reports them as errors
+        int propertyType = metaObject->property(index).userType();
+        QVariant value = object->property(key);
+        if (value.canConvert<Reference::Ptr>()) {
+            QVariant resolved = resolveReference(value.value<Reference::Ptr>(), times);
+            if (!resolved.isValid() || !resolved.canConvert(propertyType)) {
+                return false;
+            }
+        } else if (value.canConvert<Expression::Ptr>() || value.canConvert<QmlObject::Ptr>()) {
+            return false;
+        } else if (value.type() == QVariant::List) {
+            for (const QVariant &entry : value.toList()) {
+                if (entry.canConvert<Reference::Ptr>() || entry.canConvert<Expression::Ptr>()
+                    || entry.canConvert<QmlObject::Ptr>()) {
+                    return false;
+                }
+            }
+        }
+
+        if (!value.canConvert<Reference::Ptr>() && !value.canConvert(propertyType)) {
+            return false;
+        }
+    }
+
+    types.insert(typeName, type);
+    return true;
+}
+
+bool NativeRuleFactoryPrivate::prepareAction(const QVariant &value)
+{
+    QmlObject::Ptr action = value.value<QmlObject::Ptr>();
+    if (action.isNull()) {
+        return false;
+    }
+
+    if (action->type() != LAZYACTION_TYPE) {
+        return prepareComponent(action, &Action::staticMetaObject);
+    }
+
+    for (const QString &key : action->properties()) {
+        if (key != "component" && key != "releaseInterval") {
+            return false;
+        }
+    }
+
+    if (action->hasProperty("releaseInterval")
+        && action->property("releaseInterval").type() != QVariant::Double) {
+        return false;
+    }
+
+    return action->children().isEmpty()
+           && prepareComponent(action->property("component").value<QmlObject::Ptr>(),
+                               &Action::staticMetaObject);
+}
+
+NativeRuleFactory::NativeRuleFactory()
+    : d_ptr(new NativeRuleFactoryPrivate())
+{
+}
+
+NativeRuleFactory::~NativeRuleFactory()
+{
+}
+
+NativeRuleFactory * NativeRuleFactory::fromDocument(QmlDocumentBase::Ptr document,
+                                                    MetaTypeCache *cache)
+{
+    if (document.isNull() || !cache) {
+        return 0;
+    }
+
+    QmlObject::Ptr root = document->rootObject();
+    if (root.isNull() || root->type() != RULE_TYPE || !root->children().isEmpty()) {
+        return 0;
+    }
+
+    QScopedPointer<NativeRuleFactory> factory (new NativeRuleFactory());
+    NativeRuleFactoryPrivate *d = factory->d_func();
+    d->root = root;
+    d->cache = cache;
+
+    // Mappers first, since components refers to them
+    if (!d->prepareMappers(root->property("mappers"))) {
+        return 0;
+    }
+
+    for (const QString &key : root->properties()) {
+        QVariant value = root->property(key);
+        bool ok = false;
+        if (key == "name") {
+            ok = value.type() == QVariant::String;
+        } else if (key == "enabled") {
+            ok = value.type() == QVariant::Bool;
+        } else if (key == "mappers") {
+            ok = true;
+        } else if (key == "trigger") {
+            ok = d->prepareComponent(value.value<QmlObject::Ptr>(), &Trigger::staticMetaObject);
+        } else if (key == "condition") {
+            ok = d->prepareComponent(value.value<QmlObject::Ptr>(), &Condition::staticMetaObject);
+        } else if (key == "actions") {
+            QVariantList actions = value.type() == QVariant::List ? value.toList()
+                                                                  : QVariantList() << value;
+            ok = true;
+            for (const QVariant &action : actions) {
+                ok = ok && d->prepareAction(action);
+            }
+        } else {
+            // Other rule properties, like policies, are plain literals
+            int index = Rule::staticMetaObject.indexOfProperty(key.toLocal8Bit().constData());
+            ok = index != -1 && Rule::staticMetaObject.property(index).isWritable()
+                 && (value.type() == QVariant::Double || value.type() == QVariant::Bool
+                     || value.type() == QVariant::String)
+                 && value.canConvert(Rule::staticMetaObject.property(index).userType());
+        }
+
+        if (!ok) {
+            return 0;
+        }
+    }
+
+    return factory.take();
+}
+
+Rule * NativeRuleFactory::create(QObject *parent)
+{
+    Q_D(NativeRuleFactory);
+    d->errorString.clear();
+    Rule *rule = new Rule(parent);
+    rule->classBegin();
+
+    for (const QString &key : d->root->properties()) {
+        if (key != "trigger" && key != "condition" && key != "actions" && key != "mappers"
+            && !rule->setProperty(key.toLocal8Bit().constData(), d->root->property(key))) {
+            d->errorString = QString("Cannot set property %1 of %2").arg(key, RULE_TYPE);
+            delete rule;
+            return 0;
+        }
+    }
+
+    QmlObject::Ptr triggerObject = d->root->property("trigger").value<QmlObject::Ptr>();
+    if (!triggerObject.isNull()) {
+        Trigger *trigger = qobject_cast<Trigger *>(createComponent(triggerObject, d->types, d->times,
+                                                                   &d->errorString));
+        if (!trigger) {
+            d->errorString = creationError("trigger", triggerObject->type(), d->errorString);
+            delete rule;
+            return 0;
+        }
+        trigger->setParent(rule);
+        rule->setTrigger(trigger);
+    }
+
+    QmlObject::Ptr conditionObject = d->root->property("condition").value<QmlObject::Ptr>();
+    if (!conditionObject.isNull()) {
+        Condition *condition = qobject_cast<Condition *>(createComponent(conditionObject, d->types,
+                                                                         d->times, &d->errorString));
+        if (!condition) {
+            d->errorString = creationError("condition", conditionObject->type(), d->errorString);
+            delete rule;
+            return 0;
+        }
+        condition->setParent(rule);
+        rule->setCondition(condition);
+    }
+
+    QVariant actionsVariant = d->root->property("actions");
+    QVariantList actions = actionsVariant.type() == QVariant::List ? actionsVariant.toList()
+                                                                   : QVariantList() << actionsVariant;
+    QQmlListProperty<Action> actionList = rule->actions();
+    for (const QVariant &actionVariant : actions) {
+        QmlObject::Ptr actionObject = actionVariant.value<QmlObject::Ptr>();
+        if (actionObject.isNull()) {
+            continue;
+        }
+
+        Action *action = 0;
+        if (actionObject->type() == LAZYACTION_TYPE) {
+            LazyAction *lazyAction = new LazyAction(rule);
+            lazyAction->classBegin();
+            if (actionObject->hasProperty("releaseInterval")) {
+                lazyAction->setReleaseInterval(actionObject->property("releaseInterval").toInt());
+            }
+
+            // Copies are captured, as the action might outlive the factory
+            QmlObject::Ptr component = actionObject->property("component").value<QmlObject::Ptr>();
+            TypeMap types = d->types;
+            TimeMap times = d->times;
+            lazyAction->setCreator([component, types, times]() {
+                return qobject_cast<Action *>(createComponent(component, types, times));
+            });
+            lazyAction->componentComplete();
+            action = lazyAction;
+        } else {
+            action = qobject_cast<Action *>(createComponent(actionObject, d->types, d->times,
+                                                            &d->errorString));
+            if (!action) {
+                d->errorString = creationError("action", actionObject->type(), d->errorString);
+                delete rule;
+                return 0;
+            }
+            action->setParent(rule);
+        }
+        actionList.append(&actionList, action);
+    }
+
+    rule->componentComplete();
+    return rule;
+}
+
+QString NativeRuleFactory::errorString() const
+{
+    Q_D(const NativeRuleFactory);
+    return d->errorString;
+}
@@ -36,10 +36,13 @@
 #endif
 #include <QtCore/QStack>
 #include <QtCore/QTextStream>
+#include <QtCore/QTime>
 #include <QtQml/private/qqmljsengine_p.h>
 #include <QtQml/private/qqmljslexer_p.h>
 #include <QtQml/private/qqmljsparser_p.h>
 
+static const char *TIME_FORMAT = "hh:mm";
+
 struct Error
 {
     int line;
@@ -329,6 +332,10 @@ static QString formatProperty(const QString &key, const QVariant &value, int ind
     case QMetaType::Bool:
         ss << (value.toBool() ? "true" : "false");
         break;
+    case QMetaType::QTime:
+        // QML converts this literal when assigning a time property
+        ss << "\"" << value.toTime().toString(TIME_FORMAT) << "\"";
+        break;
     case QMetaType::QVariantList:
     {
         QStringList components;
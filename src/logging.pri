@@ -0,0 +1,6 @@
+# Log messages below PHONEBOT_LOG_LEVEL are compiled out.
+# Supported levels are debug (default) and warning, for example
+# qmake PHONEBOT_LOG_LEVEL=warning. Messages that are compiled in
+# can still be filtered at runtime with QLoggingCategory rules.
+isEmpty(PHONEBOT_LOG_LEVEL): PHONEBOT_LOG_LEVEL = debug
+equals(PHONEBOT_LOG_LEVEL, warning): DEFINES += QT_NO_DEBUG_OUTPUT
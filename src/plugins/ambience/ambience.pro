@@ -9,7 +9,11 @@ INCLUDEPATH += ../../lib/core \
 CONFIG += c++11
 CONFIG += plugin static
 
-HEADERS = ambienceaction.h
+include(../../config.pri)
+
+HEADERS = ambienceaction.h \
+    ambiencelogging.h
 
 SOURCES = plugin.cpp \
-    ambienceaction.cpp
+    ambienceaction.cpp \
+    ambiencelogging.cpp
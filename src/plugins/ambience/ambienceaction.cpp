@@ -30,6 +30,7 @@
  */
 
 #include "ambienceaction.h"
+#include "ambiencelogging.h"
 #include <action_p.h>
 #include <QtDBus/QDBusConnection>
 #include <QtDBus/QDBusInterface>
@@ -60,7 +61,7 @@ bool AmbienceActionPrivate::setActiveAmbience(QString ambience)
     QDBusMessage result = interface.call(DBUS_METHOD_NAME, ambience);
 
     if (result.type() == QDBusMessage::ErrorMessage) {
-        qDebug() << "Calling ambienced returned error:" << result.errorName() << result.errorMessage();
+        qCDebug(phonebotAmbience) << "Calling ambienced returned error:" << result.errorName() << result.errorMessage();
         return false;
     }
 
@@ -93,10 +94,11 @@ void AmbienceAction::setAmbience(const QString &ambience)
     }
 }
 
-bool AmbienceAction::execute(Rule *rule)
+bool AmbienceAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_D(AmbienceAction);
     Q_UNUSED(rule);
+    Q_UNUSED(event);
 
     return d->setActiveAmbience(d->ambience);
 }
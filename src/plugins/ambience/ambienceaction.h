@@ -46,7 +46,7 @@ public:
     virtual ~AmbienceAction();
     QString ambience() const;
     void setAmbience(const QString &ambience);
-    bool execute(Rule *rule);
+    bool execute(Rule *rule, TriggerEvent *event);
 Q_SIGNALS:
     void ambienceChanged();
 private:
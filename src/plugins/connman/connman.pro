@@ -9,12 +9,16 @@ INCLUDEPATH += ../../lib/core \
 CONFIG += c++11
 CONFIG += plugin static
 
+include(../../config.pri)
+
 HEADERS += dataswitchaction.h \
-    wlanswitchaction.h
+    wlanswitchaction.h \
+    connmanlogging.h
 
 SOURCES = plugin.cpp \
     dataswitchaction.cpp \
-    wlanswitchaction.cpp
+    wlanswitchaction.cpp \
+    connmanlogging.cpp
 
 include(../../3rdparty/libnemomw/connman/connman-include.pri)
 
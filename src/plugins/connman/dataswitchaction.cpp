@@ -31,6 +31,7 @@
 
 #include "dataswitchaction.h"
 #include "action_p.h"
+#include "connmanlogging.h"
 #include <NetworkManagerFactory>
 #include <NetworkManager>
 #include <NetworkService>
@@ -99,17 +100,18 @@ void DataSwitchAction::setEnable(bool enable)
     }
 }
 
-bool DataSwitchAction::execute(Rule *rule)
+bool DataSwitchAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_UNUSED(rule);
+    Q_UNUSED(event);
     Q_D(DataSwitchAction);
-    qDebug() << "Data path:" << d->networkService->path();
+    qCDebug(phonebotConnman) << "Data path:" << d->networkService->path();
     if (d->networkService->path().isEmpty()) {
         return false;
     }
 
-    qDebug() << "Data favorite:" << d->networkService->favorite();
-    qDebug() << "Data auto-connect:" << d->networkService->autoConnect();
+    qCDebug(phonebotConnman) << "Data favorite:" << d->networkService->favorite();
+    qCDebug(phonebotConnman) << "Data auto-connect:" << d->networkService->autoConnect();
     if (!d->networkService->favorite()) {
         return false;
     }
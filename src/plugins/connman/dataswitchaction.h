@@ -46,7 +46,7 @@ public:
     virtual ~DataSwitchAction();
     bool enable() const;
     void setEnable(bool enable);
-    bool execute(Rule *rule);
+    bool execute(Rule *rule, TriggerEvent *event);
 Q_SIGNALS:
     void enableChanged();
 private:
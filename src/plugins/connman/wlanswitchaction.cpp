@@ -31,6 +31,7 @@
 
 #include "wlanswitchaction.h"
 #include "action_p.h"
+#include "connmanlogging.h"
 #include <NetworkManagerFactory>
 #include <NetworkManager>
 #include <NetworkTechnology>
@@ -90,17 +91,18 @@ void WlanSwitchAction::setEnable(bool enable)
     }
 }
 
-bool WlanSwitchAction::execute(Rule *rule)
+bool WlanSwitchAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_UNUSED(rule);
+    Q_UNUSED(event);
     Q_D(WlanSwitchAction);
-    qDebug() << "Wlan path:" << d->wifiTechnology->path();
+    qCDebug(phonebotConnman) << "Wlan path:" << d->wifiTechnology->path();
     if (d->wifiTechnology->path().isEmpty()) {
         return false;
     }
 
-    qDebug() << "Wlan tethering:" << d->wifiTechnology->tethering();
-    qDebug() << "Wlan powered:" << d->wifiTechnology->powered();
+    qCDebug(phonebotConnman) << "Wlan tethering:" << d->wifiTechnology->tethering();
+    qCDebug(phonebotConnman) << "Wlan powered:" << d->wifiTechnology->powered();
 
     // Don't interrupt tethering
     if (d->wifiTechnology->tethering()) {
@@ -14,9 +14,11 @@ include(../../config.pri)
 
 HEADERS = debugtrigger.h \
     adaptor.h \
-    loggeraction.h
+    loggeraction.h \
+    debuglogging.h
 
 SOURCES = plugin.cpp \
     debugtrigger.cpp \
     adaptor.cpp \
-    loggeraction.cpp
+    loggeraction.cpp \
+    debuglogging.cpp
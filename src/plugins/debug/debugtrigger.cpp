@@ -53,6 +53,7 @@ public:
     explicit DebugTriggerPrivate(Trigger *q);
     bool registerToBus();
     void unregisterFromBus();
+    void slotOwnerDestroyed();
     QString registeredPath;
     QString path;
     bool registered;
@@ -89,13 +90,30 @@ bool DebugTriggerPrivate::registerToBus()
 
     // Register this object
     registeredPath = path.trimmed();
-    return connection.registerObject(registeredPath, q);
+    registered = connection.registerObject(registeredPath, q);
+    if (!registered) {
+        // When rules are reloaded, the path is still held by the
+        // trigger of the rule being replaced, so it is taken over
+        // once that trigger is destroyed
+        QObject *owner = connection.objectRegisteredAt(registeredPath);
+        if (owner && owner != q) {
+            QObject::connect(owner, SIGNAL(destroyed()), q, SLOT(slotOwnerDestroyed()),
+                             Qt::UniqueConnection);
+        }
+    }
+    return registered;
 }
 
 void DebugTriggerPrivate::unregisterFromBus()
 {
+    Q_Q(DebugTrigger);
+    // The path might already belong to the trigger replacing this one
     QDBusConnection connection = QDBusConnection::sessionBus();
+    if (!registered || connection.objectRegisteredAt(registeredPath) != q) {
+        return;
+    }
     connection.unregisterObject(registeredPath);
+    registered = false;
 
     QDBusInterface interface (SERVICE, ROOT, DBUS_INTERFACE);
     QDBusMessage result = interface.call(PING);
@@ -106,6 +124,13 @@ void DebugTriggerPrivate::unregisterFromBus()
     }
 }
 
+void DebugTriggerPrivate::slotOwnerDestroyed()
+{
+    if (!registered) {
+        registerToBus();
+    }
+}
+
 DebugTrigger::DebugTrigger(QObject *parent) :
     Trigger(*(new DebugTriggerPrivate(this)), parent)
 {
@@ -120,7 +145,7 @@ DebugTrigger::~DebugTrigger()
 
 void DebugTrigger::Ping()
 {
-    emit triggered();
+    fire();
 }
 
 QString DebugTrigger::path() const
@@ -145,3 +170,5 @@ void DebugTrigger::componentComplete()
         d->registerToBus();
     }
 }
+
+#include "moc_debugtrigger.cpp"
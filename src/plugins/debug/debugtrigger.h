@@ -52,6 +52,7 @@ Q_SIGNALS:
     void pathChanged();
 private:
     Q_DECLARE_PRIVATE(DebugTrigger)
+    Q_PRIVATE_SLOT(d_func(), void slotOwnerDestroyed())
 };
 
 #endif // DEBUGTRIGGER_H
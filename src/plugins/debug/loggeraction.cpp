@@ -30,7 +30,7 @@
  */
 
 #include "loggeraction.h"
-#include <QtCore/QDebug>
+#include "debuglogging.h"
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -41,6 +41,7 @@
 #include <condition.h>
 #include <rule.h>
 #include <trigger.h>
+#include <triggerevent.h>
 
 static void dumpMetadata(QTextStream &stream, QObject *object, int indent)
 {
@@ -58,11 +59,11 @@ LoggerAction::LoggerAction(QObject *parent) :
     Action(parent)
 {
     QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    qDebug() << "Writing logs at" << path;
+    qCDebug(phonebotDebug) << "Writing logs at" << path;
     QDir::root().mkpath(path);
 }
 
-bool LoggerAction::execute(Rule *rule)
+bool LoggerAction::execute(Rule *rule, TriggerEvent *event)
 {
     QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
     QDir dir (path);
@@ -74,7 +75,8 @@ bool LoggerAction::execute(Rule *rule)
     QTextStream stream (&log);
     stream << "Rule {" << endl;
     stream << "    name: \"" << rule->name() << "\"" << endl;
-    stream << "    time: " << QDateTime::currentDateTime().toString("yyyy/MM/dd hh:mm:ss") << endl;
+    QDateTime time = event ? event->timestamp() : QDateTime::currentDateTime();
+    stream << "    time: " << time.toString("yyyy/MM/dd hh:mm:ss") << endl;
 
     if (rule->trigger()) {
         stream << "    trigger: Trigger {" << endl;
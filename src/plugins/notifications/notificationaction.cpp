@@ -90,10 +90,11 @@ void NotificationAction::setText(const QString &notificationText)
     }
 }
 
-bool NotificationAction::execute(Rule *rule)
+bool NotificationAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_D(NotificationAction);
     Q_UNUSED(rule);
+    Q_UNUSED(event);
 
     Notification *notification = new Notification(this);
     notification->setTimestamp(QDateTime::currentDateTime());
@@ -49,7 +49,7 @@ public:
     void setSummary(const QString &summary);
     QString text() const;
     void setText(const QString &text);
-    bool execute(Rule *rule);
+    bool execute(Rule *rule, TriggerEvent *event);
 Q_SIGNALS:
     void textChanged();
     void summaryChanged();
@@ -8,6 +8,8 @@ INCLUDEPATH += ../../lib/core \
 
 CONFIG += plugin static
 
+include(../../config.pri)
+
 HEADERS = notificationaction.h
 
 SOURCES = plugin.cpp \
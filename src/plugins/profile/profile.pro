@@ -9,6 +9,8 @@ INCLUDEPATH += ../../lib/core \
 CONFIG += c++11
 CONFIG += plugin static
 
+include(../../config.pri)
+
 HEADERS = profileaction.h
 
 SOURCES = plugin.cpp \
@@ -45,7 +45,7 @@ public:
     explicit ProfileAction(QObject *parent = 0);
     QString profile() const;
     void setProfile(const QString &profile);
-    bool execute(Rule *rule);
+    bool execute(Rule *rule, TriggerEvent *event);
 Q_SIGNALS:
     void profileChanged();
 private:
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "calendarcondition.h"
+#include <clock.h>
+#include <condition_p.h>
+#include <triggerevent.h>
+#include <QtCore/QBitArray>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+static const char *DAYS_KEY = "days";
+static const char *FROM_KEY = "from";
+static const char *TO_KEY = "to";
+static const char *DATES_KEY = "dates";
+static const char *EXCLUDED_DATES_KEY = "excludedDates";
+static const char *START_TIME_KEY = "startTime";
+static const char *END_TIME_KEY = "endTime";
+static const int COMPILED_DAYS = 366;
+static const int MINUTES_PER_DAY = 1440;
+
+static QSet<QDate> parseDates(const QString &dates)
+{
+    QSet<QDate> returned;
+    for (const QString &date : dates.split(",", QString::SkipEmptyParts)) {
+        QDate parsed = QDate::fromString(date.trimmed(), Qt::ISODate);
+        if (parsed.isValid()) {
+            returned.insert(parsed);
+        }
+    }
+    return returned;
+}
+
+static int parseDayMask(const QString &days)
+{
+    int mask = 0;
+    for (const QString &day : days.split(",", QString::SkipEmptyParts)) {
+        bool ok = false;
+        int dayNumber = day.trimmed().toInt(&ok);
+        if (ok && dayNumber >= Qt::Monday && dayNumber <= Qt::Sunday) {
+            mask |= 1 << (dayNumber - Qt::Monday);
+        }
+    }
+    return mask;
+}
+
+static int minuteOfDay(const QTime &time)
+{
+    return time.hour() * 60 + time.minute();
+}
+
+class CalendarConditionPrivate: public ConditionPrivate
+{
+public:
+    explicit CalendarConditionPrivate(CalendarCondition *q);
+    void invalidate();
+    void compile(const QDate &date) const;
+    int dayIndex(const QDate &date) const;
+    QString days;
+    QString from;
+    QString to;
+    QString dates;
+    QString excludedDates;
+    QTime startTime;
+    QTime endTime;
+    // Active days, starting from compiledFrom, and active minutes of the day
+    mutable QDate compiledFrom;
+    mutable QBitArray dayBits;
+    mutable QBitArray minuteBits;
+};
+
+CalendarConditionPrivate::CalendarConditionPrivate(CalendarCondition *q)
+    : ConditionPrivate(q)
+{
+}
+
+void CalendarConditionPrivate::invalidate()
+{
+    compiledFrom = QDate();
+}
+
+void CalendarConditionPrivate::compile(const QDate &date) const
+{
+    // Empty days mean every day of the week
+    int dayMask = days.trimmed().isEmpty() ? 0x7f : parseDayMask(days);
+    QDate fromDate = QDate::fromString(from.trimmed(), Qt::ISODate);
+    QDate toDate = QDate::fromString(to.trimmed(), Qt::ISODate);
+    QSet<QDate> includedDates = parseDates(dates);
+    QSet<QDate> excluded = parseDates(excludedDates);
+
+    compiledFrom = date;
+    dayBits = QBitArray(COMPILED_DAYS);
+    for (int i = 0; i < COMPILED_DAYS; ++i) {
+        QDate current = date.addDays(i);
+        bool active = false;
+        if (!includedDates.isEmpty()) {
+            active = includedDates.contains(current);
+        } else {
+            active = (dayMask & (1 << (current.dayOfWeek() - Qt::Monday)))
+                     && (!fromDate.isValid() || current >= fromDate)
+                     && (!toDate.isValid() || current <= toDate);
+        }
+        dayBits.setBit(i, active && !excluded.contains(current));
+    }
+
+    // A window ending before it starts wraps around midnight
+    minuteBits = QBitArray(MINUTES_PER_DAY, !startTime.isValid() || !endTime.isValid());
+    if (startTime.isValid() && endTime.isValid()) {
+        int start = minuteOfDay(startTime);
+        int end = minuteOfDay(endTime);
+        for (int i = start; i != end; i = (i + 1) % MINUTES_PER_DAY) {
+            minuteBits.setBit(i);
+        }
+        minuteBits.setBit(end);
+    }
+}
+
+int CalendarConditionPrivate::dayIndex(const QDate &date) const
+{
+    if (!date.isValid()) {
+        return -1;
+    }
+
+    qint64 index = compiledFrom.isValid() ? compiledFrom.daysTo(date) : -1;
+    if (index < 0 || index >= COMPILED_DAYS) {
+        // The bitmap covers the year from the first queried day,
+        // and is recompiled when a query falls out of it
+        compile(date);
+        index = 0;
+    }
+    return index;
+}
+
+CalendarCondition::CalendarCondition(QObject *parent) :
+    Condition(*(new CalendarConditionPrivate(this)), parent)
+{
+}
+
+QString CalendarCondition::days() const
+{
+    Q_D(const CalendarCondition);
+    return d->days;
+}
+
+void CalendarCondition::setDays(const QString &days)
+{
+    Q_D(CalendarCondition);
+    if (d->days != days) {
+        d->days = days;
+        d->invalidate();
+        emit daysChanged();
+    }
+}
+
+QString CalendarCondition::from() const
+{
+    Q_D(const CalendarCondition);
+    return d->from;
+}
+
+void CalendarCondition::setFrom(const QString &from)
+{
+    Q_D(CalendarCondition);
+    if (d->from != from) {
+        d->from = from;
+        d->invalidate();
+        emit fromChanged();
+    }
+}
+
+QString CalendarCondition::to() const
+{
+    Q_D(const CalendarCondition);
+    return d->to;
+}
+
+void CalendarCondition::setTo(const QString &to)
+{
+    Q_D(CalendarCondition);
+    if (d->to != to) {
+        d->to = to;
+        d->invalidate();
+        emit toChanged();
+    }
+}
+
+QString CalendarCondition::dates() const
+{
+    Q_D(const CalendarCondition);
+    return d->dates;
+}
+
+void CalendarCondition::setDates(const QString &dates)
+{
+    Q_D(CalendarCondition);
+    if (d->dates != dates) {
+        d->dates = dates;
+        d->invalidate();
+        emit datesChanged();
+    }
+}
+
+QString CalendarCondition::excludedDates() const
+{
+    Q_D(const CalendarCondition);
+    return d->excludedDates;
+}
+
+void CalendarCondition::setExcludedDates(const QString &excludedDates)
+{
+    Q_D(CalendarCondition);
+    if (d->excludedDates != excludedDates) {
+        d->excludedDates = excludedDates;
+        d->invalidate();
+        emit excludedDatesChanged();
+    }
+}
+
+QTime CalendarCondition::startTime() const
+{
+    Q_D(const CalendarCondition);
+    return d->startTime;
+}
+
+void CalendarCondition::setStartTime(const QTime &startTime)
+{
+    Q_D(CalendarCondition);
+    if (d->startTime != startTime) {
+        d->startTime = startTime;
+        d->invalidate();
+        emit startTimeChanged();
+    }
+}
+
+QTime CalendarCondition::endTime() const
+{
+    Q_D(const CalendarCondition);
+    return d->endTime;
+}
+
+void CalendarCondition::setEndTime(const QTime &endTime)
+{
+    Q_D(CalendarCondition);
+    if (d->endTime != endTime) {
+        d->endTime = endTime;
+        d->invalidate();
+        emit endTimeChanged();
+    }
+}
+
+bool CalendarCondition::isActiveOn(const QDate &date) const
+{
+    Q_D(const CalendarCondition);
+    int index = d->dayIndex(date);
+    return index != -1 && d->dayBits.testBit(index);
+}
+
+bool CalendarCondition::isActiveAt(const QDateTime &dateTime) const
+{
+    Q_D(const CalendarCondition);
+    if (!isActiveOn(dateTime.date())) {
+        return false;
+    }
+    return d->minuteBits.testBit(minuteOfDay(dateTime.time()));
+}
+
+QDate CalendarCondition::nextActiveDate(const QDate &date) const
+{
+    for (int i = 0; i < COMPILED_DAYS; ++i) {
+        QDate current = date.addDays(i);
+        if (isActiveOn(current)) {
+            return current;
+        }
+    }
+    return QDate();
+}
+
+bool CalendarCondition::isValid(Rule *rule, TriggerEvent *event)
+{
+    Q_UNUSED(rule);
+    return isActiveAt(event ? event->timestamp() : Clock::instance()->currentDateTime());
+}
+
+CalendarConditionMeta::CalendarConditionMeta(QObject *parent)
+    : AbstractMetaData(parent)
+{
+}
+
+QString CalendarConditionMeta::name() const
+{
+    return tr("Calendar");
+}
+
+QString CalendarConditionMeta::description() const
+{
+    return tr("This condition will check if the current day and time match a calendar.");
+}
+
+QString CalendarConditionMeta::summary(const QVariantMap &properties) const
+{
+    QTime startTime = properties.value(START_TIME_KEY).toTime();
+    QTime endTime = properties.value(END_TIME_KEY).toTime();
+    if (startTime.isValid() && endTime.isValid()) {
+        return tr("Between %1 and %2").arg(startTime.toString(tr("hh:mm")),
+                                            endTime.toString(tr("hh:mm")));
+    }
+    return name();
+}
+
+MetaProperty * CalendarConditionMeta::getProperty(const QString &property, QObject *parent) const
+{
+    if (property == DAYS_KEY) {
+        return MetaProperty::createString(property, tr("Days of week (1 for Monday to 7 for Sunday)"),
+                                          parent);
+    }
+    if (property == FROM_KEY) {
+        return MetaProperty::createString(property, tr("First day (YYYY-MM-DD)"), parent);
+    }
+    if (property == TO_KEY) {
+        return MetaProperty::createString(property, tr("Last day (YYYY-MM-DD)"), parent);
+    }
+    if (property == DATES_KEY) {
+        return MetaProperty::createString(property, tr("Only on these days"), parent);
+    }
+    if (property == EXCLUDED_DATES_KEY) {
+        return MetaProperty::createString(property, tr("Except on these days"), parent);
+    }
+    if (property == START_TIME_KEY) {
+        return MetaProperty::create(property, MetaProperty::Time, tr("Start time"), parent);
+    }
+    if (property == END_TIME_KEY) {
+        return MetaProperty::create(property, MetaProperty::Time, tr("End time"), parent);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef CALENDARCONDITION_H
+#define CALENDARCONDITION_H
+
+#include <condition.h>
+#include <abstractmetadata.h>
+#include <QtCore/QDate>
+#include <QtCore/QTime>
+
+class CalendarConditionPrivate;
+class CalendarCondition : public Condition
+{
+    Q_OBJECT
+    Q_PROPERTY(QString days READ days WRITE setDays NOTIFY daysChanged)
+    Q_PROPERTY(QString from READ from WRITE setFrom NOTIFY fromChanged)
+    Q_PROPERTY(QString to READ to WRITE setTo NOTIFY toChanged)
+    Q_PROPERTY(QString dates READ dates WRITE setDates NOTIFY datesChanged)
+    Q_PROPERTY(QString excludedDates READ excludedDates WRITE setExcludedDates
+               NOTIFY excludedDatesChanged)
+    Q_PROPERTY(QTime startTime READ startTime WRITE setStartTime NOTIFY startTimeChanged)
+    Q_PROPERTY(QTime endTime READ endTime WRITE setEndTime NOTIFY endTimeChanged)
+    PHONEBOT_METADATA(CalendarConditionMeta)
+public:
+    explicit CalendarCondition(QObject *parent = 0);
+    QString days() const;
+    void setDays(const QString &days);
+    QString from() const;
+    void setFrom(const QString &from);
+    QString to() const;
+    void setTo(const QString &to);
+    QString dates() const;
+    void setDates(const QString &dates);
+    QString excludedDates() const;
+    void setExcludedDates(const QString &excludedDates);
+    QTime startTime() const;
+    void setStartTime(const QTime &startTime);
+    QTime endTime() const;
+    void setEndTime(const QTime &endTime);
+    bool isActiveOn(const QDate &date) const;
+    bool isActiveAt(const QDateTime &dateTime) const;
+    QDate nextActiveDate(const QDate &date) const;
+    bool isValid(Rule *rule, TriggerEvent *event) override;
+Q_SIGNALS:
+    void daysChanged();
+    void fromChanged();
+    void toChanged();
+    void datesChanged();
+    void excludedDatesChanged();
+    void startTimeChanged();
+    void endTimeChanged();
+private:
+    Q_DECLARE_PRIVATE(CalendarCondition)
+};
+
+class CalendarConditionMeta: public AbstractMetaData
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE explicit CalendarConditionMeta(QObject * parent = 0);
+    QString name() const;
+    QString description() const;
+    QString summary(const QVariantMap &properties) const;
+protected:
+    MetaProperty * getProperty(const QString &property, QObject *parent = 0) const;
+};
+
+#endif // CALENDARCONDITION_H
@@ -31,6 +31,7 @@
 
 #include <phonebotextensionplugin.h>
 #include <QtQml/qqml.h>
+#include "calendarcondition.h"
 #include "timetrigger.h"
 #include "weekdaycondition.h"
 
@@ -45,6 +46,8 @@ public:
         qRegisterMetaType<TimeTriggerMeta *>();
         qmlRegisterType<WeekDayCondition>("org.SfietKonstantin.phonebot.time", 1, 0, "WeekDayCondition");
         qRegisterMetaType<WeekDayConditionMeta *>();
+        qmlRegisterType<CalendarCondition>("org.SfietKonstantin.phonebot.time", 1, 0, "CalendarCondition");
+        qRegisterMetaType<CalendarConditionMeta *>();
     }
 };
 
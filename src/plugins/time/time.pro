@@ -9,12 +9,18 @@ INCLUDEPATH += ../../lib/core \
 CONFIG += c++11
 CONFIG += plugin static
 
+include(../../config.pri)
+
 HEADERS = timetrigger.h \
-    weekdaycondition.h
+    weekdaycondition.h \
+    calendarcondition.h \
+    timelogging.h
 
 SOURCES = plugin.cpp \
     timetrigger.cpp \
-    weekdaycondition.cpp
+    weekdaycondition.cpp \
+    calendarcondition.cpp \
+    timelogging.cpp
 
 include(../../3rdparty/libnemomw/keepalive/keepalive-include.pri)
 
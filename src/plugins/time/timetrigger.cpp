@@ -31,15 +31,20 @@
 
 #include "timetrigger.h"
 #include "trigger_p.h"
+#include "calendarcondition.h"
+#include "timelogging.h"
+#include <clock.h>
+#include <clocktimer.h>
+#include <continuationscheduler.h>
 #include <QtCore/QDate>
-#include <QtCore/QDebug>
-#include <QtCore/QTimer>
 #include <BackgroundJob>
 
 static const char *TIME_KEY = "time";
 static const int DELTA = 600000; // 10 minutes in msecs
 static const int PRECISE_TIMER_INTERVAL = 6000; // 6 secs in msecs
 static const int PRECISE_DELTA = 5000; // 10 secs in msecs
+static const qint64 COARSE_DELTA = 7200000; // 2 hours in msecs
+static const int COARSE_WAKE_UP_INTERVAL = 3600000; // 1 hour in msecs
 
 class TimeTriggerPrivate: public TriggerPrivate
 {
@@ -47,72 +52,156 @@ public:
     explicit TimeTriggerPrivate(Trigger *q);
     void slotTriggered();
     void slotTimerTriggered();
+    void updateFrequency();
+    void beginWakeUp();
+    void finishWakeUp();
     QTime time;
     QDate lastEmission;
+    CalendarCondition *calendar;
+    bool coarse;
     BackgroundJob *backgroundJob;
-    QTimer *timer;
+    ClockTimer *wakeUpTimer;
+    ClockTimer *timer;
 private:
     Q_DECLARE_PUBLIC(TimeTrigger)
 };
 
 TimeTriggerPrivate::TimeTriggerPrivate(Trigger *q)
-    : TriggerPrivate(q), backgroundJob(0), timer(0)
+    : TriggerPrivate(q), calendar(0), coarse(false), backgroundJob(0), wakeUpTimer(0), timer(0)
 {
 }
 
 void TimeTriggerPrivate::slotTriggered()
 {
-    backgroundJob->begin();
-    qDebug() << "Wake up time" << QTime::currentTime();
+    Q_Q(TimeTrigger);
+    if (q->isPassive()) {
+        return;
+    }
+
+    Clock *clock = Clock::instance();
+    beginWakeUp();
+    qCDebug(phonebotTime) << "Wake up time" << clock->currentTime();
+
+    // Delayed actions piggyback on this wake up
+    ContinuationScheduler::instance()->processDue();
 
     // If we need to be triggered (not last emission, timer not active
-    // and delta < 10 min, we start the timer, and don't finish the job
-    if (!timer->isActive() && lastEmission != QDate::currentDate()) {
-        int delta = QTime::currentTime().msecsTo(time);
+    // and delta < 10 min, we start the timer, and don't finish the job.
+    // Days that are not in the calendar are skipped.
+    if (!timer->isActive() && lastEmission != clock->currentDate()
+        && (!calendar || calendar->isActiveOn(clock->currentDate()))) {
+        int delta = clock->currentTime().msecsTo(time);
         if (delta >= 0 && delta < DELTA) {
             timer->start();
+            // The timer only ticks after its interval, that
+            // would miss a wake up already in the precise window
+            if (delta < PRECISE_DELTA) {
+                slotTimerTriggered();
+            }
             return;
         }
     }
-    backgroundJob->finished();
+    updateFrequency();
+    finishWakeUp();
 }
 
 void TimeTriggerPrivate::slotTimerTriggered()
 {
     Q_Q(TimeTrigger);
-    int delta = time.msecsTo(QTime::currentTime());
+    if (q->isPassive()) {
+        timer->stop();
+        return;
+    }
+
+    Clock *clock = Clock::instance();
+    int delta = time.msecsTo(clock->currentTime());
     if (delta >= -PRECISE_DELTA && delta < PRECISE_DELTA) {
-        if (lastEmission != QDate::currentDate()) {
-            lastEmission = QDate::currentDate(); // Ensure that the signal is emitted once per day
-            qDebug() << "Triggered time:" << QTime::currentTime();
+        if (lastEmission != clock->currentDate()) {
+            lastEmission = clock->currentDate(); // Ensure that the signal is emitted once per day
+            qCDebug(phonebotTime) << "Triggered time:" << clock->currentTime();
             timer->stop();
-            emit q->triggered();
-            backgroundJob->finished();
+            QVariantMap payload;
+            payload.insert(TIME_KEY, time);
+            q->fire(payload);
+            updateFrequency();
+            finishWakeUp();
+        }
+    }
+}
+
+void TimeTriggerPrivate::updateFrequency()
+{
+    Q_Q(TimeTrigger);
+    // Wake up every hour when the next trigger is far
+    // away, this still gives a wake up in the last hour
+    QDateTime next = q->nextTriggerTime();
+    QDateTime nextContinuation = ContinuationScheduler::instance()->nextDeadline();
+    if (nextContinuation.isValid() && (!next.isValid() || nextContinuation < next)) {
+        next = nextContinuation;
+    }
+    bool newCoarse = !next.isValid()
+                     || Clock::instance()->currentDateTime().msecsTo(next) > COARSE_DELTA;
+    if (coarse != newCoarse) {
+        coarse = newCoarse;
+        if (backgroundJob) {
+            backgroundJob->setFrequency(coarse ? DeclarativeBackgroundJob::OneHour
+                                               : DeclarativeBackgroundJob::TenMinutes);
         }
     }
 }
 
+void TimeTriggerPrivate::beginWakeUp()
+{
+    if (backgroundJob) {
+        backgroundJob->begin();
+    }
+}
+
+void TimeTriggerPrivate::finishWakeUp()
+{
+    // With a simulated clock, wake ups are scheduled on the clock,
+    // using the same frequencies as the background job
+    if (backgroundJob) {
+        backgroundJob->finished();
+    } else {
+        wakeUpTimer->start(coarse ? COARSE_WAKE_UP_INTERVAL : DELTA);
+    }
+}
+
 TimeTrigger::~TimeTrigger()
 {
     Q_D(TimeTrigger);
-    d->backgroundJob->setEnabled(false);
+    if (d->backgroundJob) {
+        d->backgroundJob->setEnabled(false);
+    }
 }
 
 TimeTrigger::TimeTrigger(QObject *parent) :
     Trigger(*(new TimeTriggerPrivate(this)), parent)
 {
     Q_D(TimeTrigger);
-    d->backgroundJob = new DeclarativeBackgroundJob(this);
-    d->backgroundJob->classBegin();
-    d->backgroundJob->componentComplete();
-    d->backgroundJob->setFrequency(DeclarativeBackgroundJob::TenMinutes);
-    connect(d->backgroundJob, SIGNAL(triggered()), this, SLOT(slotTriggered()));
-    d->backgroundJob->setEnabled(true);
-
-    d->timer = new QTimer(this);
+    if (Clock::instance()->isSimulated()) {
+        d->wakeUpTimer = new ClockTimer(this);
+        d->wakeUpTimer->setSingleShot(true);
+        connect(d->wakeUpTimer, SIGNAL(timeout()), this, SLOT(slotTriggered()));
+        d->wakeUpTimer->start(0);
+    } else {
+        d->backgroundJob = new DeclarativeBackgroundJob(this);
+        d->backgroundJob->classBegin();
+        d->backgroundJob->componentComplete();
+        d->backgroundJob->setFrequency(DeclarativeBackgroundJob::TenMinutes);
+        connect(d->backgroundJob, SIGNAL(triggered()), this, SLOT(slotTriggered()));
+        d->backgroundJob->setEnabled(true);
+    }
+
+    d->timer = new ClockTimer(this);
     d->timer->setSingleShot(false);
     d->timer->setInterval(PRECISE_TIMER_INTERVAL);
     connect(d->timer, SIGNAL(timeout()), this, SLOT(slotTimerTriggered()));
+    connect(ContinuationScheduler::instance(), &ContinuationScheduler::nextDeadlineChanged,
+            this, [d]() {
+        d->updateFrequency();
+    });
 }
 
 QTime TimeTrigger::time() const
@@ -126,11 +215,50 @@ void TimeTrigger::setTime(const QTime &time)
     Q_D(TimeTrigger);
     if (d->time != time) {
         d->time = time;
-        qDebug() << "Time set:" << time;
+        qCDebug(phonebotTime) << "Time set:" << time;
+        d->updateFrequency();
         emit timeChanged();
     }
 }
 
+CalendarCondition * TimeTrigger::calendar() const
+{
+    Q_D(const TimeTrigger);
+    return d->calendar;
+}
+
+void TimeTrigger::setCalendar(CalendarCondition *calendar)
+{
+    Q_D(TimeTrigger);
+    if (d->calendar != calendar) {
+        d->calendar = calendar;
+        d->updateFrequency();
+        emit calendarChanged();
+    }
+}
+
+QDateTime TimeTrigger::nextTriggerTime() const
+{
+    Q_D(const TimeTrigger);
+    if (!d->time.isValid()) {
+        return QDateTime();
+    }
+
+    Clock *clock = Clock::instance();
+    QDate date = clock->currentDate();
+    if (d->lastEmission == date || d->time.msecsTo(clock->currentTime()) >= PRECISE_DELTA) {
+        date = date.addDays(1);
+    }
+
+    if (d->calendar) {
+        date = d->calendar->nextActiveDate(date);
+        if (!date.isValid()) {
+            return QDateTime();
+        }
+    }
+    return QDateTime(date, d->time);
+}
+
 TimeTriggerMeta::TimeTriggerMeta(QObject *parent)
     : AbstractMetaData(parent)
 {
@@ -36,19 +36,25 @@
 #include <abstractmetadata.h>
 #include <QtCore/QTime>
 
+class CalendarCondition;
 class TimeTriggerPrivate;
 class TimeTrigger : public Trigger
 {
     Q_OBJECT
     Q_PROPERTY(QTime time READ time WRITE setTime NOTIFY timeChanged)
+    Q_PROPERTY(CalendarCondition * calendar READ calendar WRITE setCalendar NOTIFY calendarChanged)
     PHONEBOT_METADATA(TimeTriggerMeta)
 public:
     explicit TimeTrigger(QObject *parent = 0);
     virtual ~TimeTrigger();
     QTime time() const;
     void setTime(const QTime &time);
+    CalendarCondition * calendar() const;
+    void setCalendar(CalendarCondition *calendar);
+    QDateTime nextTriggerTime() const override;
 Q_SIGNALS:
     void timeChanged();
+    void calendarChanged();
 private:
     Q_DECLARE_PRIVATE(TimeTrigger)
     Q_PRIVATE_SLOT(d_func(), void slotTriggered())
@@ -30,7 +30,9 @@
  */
 
 #include "weekdaycondition.h"
+#include <clock.h>
 #include <condition_p.h>
+#include <triggerevent.h>
 #include <QtCore/QDate>
 #include <QtCore/QSet>
 #include <QtCore/QStringList>
@@ -207,11 +209,12 @@ void WeekDayCondition::setOnSunday(bool onSunday)
     }
 }
 
-bool WeekDayCondition::isValid(Rule *rule)
+bool WeekDayCondition::isValid(Rule *rule, TriggerEvent *event)
 {
     Q_D(WeekDayCondition);
     Q_UNUSED(rule);
-    int day = QDate::currentDate().dayOfWeek();
+    QDate date = event ? event->timestamp().date() : Clock::instance()->currentDate();
+    int day = date.dayOfWeek();
     return d->checkedDays.contains(day);
 }
 
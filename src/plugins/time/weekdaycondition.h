@@ -63,7 +63,7 @@ public:
     void setOnSaturday(bool onSaturday);
     bool isOnSunday() const;
     void setOnSunday(bool onSunday);
-    bool isValid(Rule *rule);
+    bool isValid(Rule *rule, TriggerEvent *event);
 Q_SIGNALS:
     void onMondayChanged();
     void onTuesdayChanged();
@@ -3,4 +3,6 @@ SUBDIRS += tst_phonebotengine \
     tst_rule \
     tst_debugplugin \
     tst_meta \
-    tst_parser
+    tst_parser \
+    tst_allocations \
+    tst_timeplugin
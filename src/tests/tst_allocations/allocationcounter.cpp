@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include "allocationcounter.h"
+#include <atomic>
+
+#ifdef __GLIBC__
+#include <errno.h>
+#include <malloc.h>
+
+extern "C" {
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void *ptr, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+#endif
+
+static std::atomic<bool> enabled (false);
+static std::atomic<qint64> allocations (0);
+static std::atomic<qint64> frees (0);
+static std::atomic<qint64> allocatedBytes (0);
+static std::atomic<qint64> liveBytes (0);
+static std::atomic<qint64> foreignFrees (0);
+
+#ifdef __GLIBC__
+// Blocks allocated while counting, in an open addressing set that
+// does not allocate. Removed entries are marked with a tombstone,
+// that is reused by insertions. The set is cleared when counting
+// starts.
+static const int BLOCK_TABLE_BITS = 21;
+static const size_t BLOCK_TABLE_SIZE = size_t(1) << BLOCK_TABLE_BITS;
+static const size_t MAX_PROBES = 4096;
+static void * const TOMBSTONE = reinterpret_cast<void *>(1);
+static std::atomic<void *> blocks[BLOCK_TABLE_SIZE];
+
+static size_t blockHash(void *ptr)
+{
+    quint64 value = reinterpret_cast<quintptr>(ptr) >> 4;
+    return (value * Q_UINT64_C(0x9e3779b97f4a7c15)) >> (64 - BLOCK_TABLE_BITS);
+}
+
+// A block that cannot be inserted is still counted, but
+// its free is reported as foreign, and it stays live
+static void insertBlock(void *ptr)
+{
+    size_t index = blockHash(ptr);
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+        std::atomic<void *> &slot = blocks[(index + i) & (BLOCK_TABLE_SIZE - 1)];
+        void *current = slot.load(std::memory_order_relaxed);
+        while (current == 0 || current == TOMBSTONE) {
+            if (slot.compare_exchange_weak(current, ptr, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+}
+
+// A block address is only live once, so it cannot be
+// inserted and removed concurrently
+static bool removeBlock(void *ptr)
+{
+    size_t index = blockHash(ptr);
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+        std::atomic<void *> &slot = blocks[(index + i) & (BLOCK_TABLE_SIZE - 1)];
+        void *current = slot.load(std::memory_order_relaxed);
+        if (current == 0) {
+            return false;
+        }
+        if (current == ptr) {
+            return slot.compare_exchange_strong(current, TOMBSTONE, std::memory_order_relaxed);
+        }
+    }
+    return false;
+}
+
+static void * counted(void *ptr)
+{
+    if (ptr && enabled.load(std::memory_order_relaxed)) {
+        qint64 size = malloc_usable_size(ptr);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        liveBytes.fetch_add(size, std::memory_order_relaxed);
+        insertBlock(ptr);
+    }
+    return ptr;
+}
+
+// Only blocks allocated while counting are uncounted. The
+// block is removed from the set before being released, as
+// another thread might get the same address right after.
+static bool uncount(void *ptr)
+{
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (!removeBlock(ptr)) {
+        foreignFrees.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    frees.fetch_add(1, std::memory_order_relaxed);
+    liveBytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+    return true;
+}
+
+// Operators new and delete from libstdc++ end up in these
+// functions, as the executable takes precedence over glibc
+extern "C" {
+
+void * malloc(size_t size)
+{
+    return counted(__libc_malloc(size));
+}
+
+void * calloc(size_t count, size_t size)
+{
+    return counted(__libc_calloc(count, size));
+}
+
+void * realloc(void *ptr, size_t size)
+{
+    bool wasCounted = ptr && uncount(ptr);
+    void *returned = __libc_realloc(ptr, size);
+    // The original block is left untouched if the reallocation failed
+    if (wasCounted && !returned && size != 0) {
+        frees.fetch_sub(1, std::memory_order_relaxed);
+        liveBytes.fetch_add(malloc_usable_size(ptr), std::memory_order_relaxed);
+        insertBlock(ptr);
+    }
+    return counted(returned);
+}
+
+void * memalign(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+void * aligned_alloc(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    void *returned = counted(__libc_memalign(alignment, size));
+    if (!returned) {
+        return ENOMEM;
+    }
+    *ptr = returned;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    if (ptr) {
+        uncount(ptr);
+    }
+    __libc_free(ptr);
+}
+
+}
+#endif
+
+AllocationCounter::Snapshot::Snapshot()
+    : allocations(0), frees(0), allocatedBytes(0), liveBytes(0), foreignFrees(0)
+{
+}
+
+AllocationCounter::Snapshot AllocationCounter::Snapshot::operator-(const Snapshot &other) const
+{
+    Snapshot difference;
+    difference.allocations = allocations - other.allocations;
+    difference.frees = frees - other.frees;
+    difference.allocatedBytes = allocatedBytes - other.allocatedBytes;
+    difference.liveBytes = liveBytes - other.liveBytes;
+    difference.foreignFrees = foreignFrees - other.foreignFrees;
+    return difference;
+}
+
+qint64 AllocationCounter::Snapshot::liveBlocks() const
+{
+    return allocations - frees;
+}
+
+bool AllocationCounter::isAvailable()
+{
+#ifdef __GLIBC__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationCounter::setEnabled(bool enabled)
+{
+#ifdef __GLIBC__
+    if (enabled && !::enabled.load()) {
+        for (size_t i = 0; i < BLOCK_TABLE_SIZE; ++i) {
+            blocks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+#endif
+    ::enabled.store(enabled);
+}
+
+AllocationCounter::Snapshot AllocationCounter::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.allocations = allocations.load();
+    snapshot.frees = frees.load();
+    snapshot.allocatedBytes = allocatedBytes.load();
+    snapshot.liveBytes = liveBytes.load();
+    snapshot.foreignFrees = foreignFrees.load();
+    return snapshot;
+}
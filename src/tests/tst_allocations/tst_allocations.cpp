@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtCore/QtPlugin>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtDBus/QDBusConnection>
+#include <functional>
+#include <phonebotengine.h>
+#include <qmldocument.h>
+#include <rulesmodel.h>
+#include "allocationcounter.h"
+
+Q_IMPORT_PLUGIN(PhoneBotDebugPlugin)
+
+static const char *RULE_FILE = ":/allocationrule.qml";
+static const char *SERVICE = "org.SfietKonstantin.phonebot";
+static const char *PATH = "/";
+static const int WARMUP_CYCLES = 3;
+static const int CYCLES = 20;
+static const int RULE_COUNT = 10;
+
+// Ceilings per cycle, with a 25% margin over the baselines. The
+// baselines are estimates of 1200, 6400 and 32000 allocations, that
+// were not measured yet: run the test with PHONEBOT_ALLOCATIONS_VERBOSE
+// set to print the counts, and update both when allocations change.
+static const qint64 MAX_PARSE_ALLOCATIONS = 1500;
+static const qint64 MAX_ENGINE_ALLOCATIONS = 8000;
+static const qint64 MAX_RULES_MODEL_ALLOCATIONS = 40000;
+// Blocks allocated while counting and never freed
+static const qint64 MAX_RETAINED_BYTES = 256;
+
+// Provides the rules to RulesModel, in place of the daemon
+class FakeDaemon: public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.SfietKonstantin.phonebot")
+public:
+    explicit FakeDaemon(QObject *parent = 0) : QObject(parent) {}
+public Q_SLOTS:
+    QStringList Rules() const
+    {
+        QStringList rules;
+        for (int i = 0; i < RULE_COUNT; ++i) {
+            rules.append(RULE_FILE);
+        }
+        return rules;
+    }
+};
+
+class TstAllocations : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testParse();
+    void testEngine();
+    void testRulesModel();
+    void cleanupTestCase();
+};
+
+static void processDeferredDeletes()
+{
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+}
+
+// Runs some cycles to warm caches up, and count
+// the allocations of the cycles that follow
+static AllocationCounter::Snapshot measure(const std::function<void ()> &cycle)
+{
+    for (int i = 0; i < WARMUP_CYCLES; ++i) {
+        cycle();
+        processDeferredDeletes();
+    }
+
+    AllocationCounter::Snapshot before = AllocationCounter::snapshot();
+    AllocationCounter::setEnabled(true);
+    for (int i = 0; i < CYCLES; ++i) {
+        cycle();
+        processDeferredDeletes();
+    }
+    AllocationCounter::setEnabled(false);
+    return AllocationCounter::snapshot() - before;
+}
+
+static QString check(const AllocationCounter::Snapshot &measured, qint64 maxAllocations)
+{
+    qint64 allocations = measured.allocations / CYCLES;
+    qint64 retained = measured.liveBytes / CYCLES;
+    if (qEnvironmentVariableIsSet("PHONEBOT_ALLOCATIONS_VERBOSE")) {
+        qDebug() << "Per cycle:" << allocations << "allocations," << measured.allocatedBytes / CYCLES
+                 << "bytes," << retained << "retained bytes," << measured.liveBlocks() / CYCLES
+                 << "retained blocks," << measured.foreignFrees / CYCLES << "foreign frees";
+    }
+    if (allocations > maxAllocations) {
+        return QString("%1 allocations per cycle, more than %2").arg(allocations).arg(maxAllocations);
+    }
+    if (retained > MAX_RETAINED_BYTES) {
+        return QString("%1 bytes retained per cycle, more than %2").arg(retained).arg(MAX_RETAINED_BYTES);
+    }
+    return QString();
+}
+
+void TstAllocations::initTestCase()
+{
+    if (!AllocationCounter::isAvailable()) {
+        QSKIP("Allocations can only be counted with glibc");
+    }
+    PhoneBotEngine::registerTypes();
+}
+
+void TstAllocations::testParse()
+{
+    QmlDocument::Ptr document = QmlDocument::create(RULE_FILE);
+    QCOMPARE(document->error(), QmlDocument::NoError);
+
+    AllocationCounter::Snapshot measured = measure([]() {
+        QmlDocument::create(RULE_FILE);
+    });
+    QString error = check(measured, MAX_PARSE_ALLOCATIONS);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void TstAllocations::testEngine()
+{
+    PhoneBotEngine engine;
+    QUrl source (QString("qrc%1").arg(RULE_FILE));
+    QSignalSpy spy (&engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    engine.addComponent(source);
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY(spy.first().at(1).toBool());
+
+    AllocationCounter::Snapshot measured = measure([&engine]() {
+        engine.start();
+        while (!engine.isReady()) {
+            QCoreApplication::processEvents();
+        }
+        engine.stop();
+        processDeferredDeletes();
+        engine.collectGarbage();
+    });
+    QString error = check(measured, MAX_ENGINE_ALLOCATIONS);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void TstAllocations::testRulesModel()
+{
+    QDBusConnection connection = QDBusConnection::sessionBus();
+    FakeDaemon daemon;
+    if (!connection.registerService(SERVICE)) {
+        QSKIP("The daemon is already running on the session bus");
+    }
+    QVERIFY(connection.registerObject(PATH, &daemon, QDBusConnection::ExportAllSlots));
+
+    RulesModel model;
+    QCOMPARE(model.count(), RULE_COUNT);
+
+    AllocationCounter::Snapshot measured = measure([&model]() {
+        model.reload();
+    });
+    connection.unregisterObject(PATH);
+    connection.unregisterService(SERVICE);
+
+    QString error = check(measured, MAX_RULES_MODEL_ALLOCATIONS);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void TstAllocations::cleanupTestCase()
+{
+    QTest::qWait(100); // Process delete later
+}
+
+
+QTEST_MAIN(TstAllocations)
+
+#include "tst_allocations.moc"
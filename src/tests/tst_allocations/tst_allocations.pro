@@ -0,0 +1,24 @@
+TEMPLATE = app
+TARGET = tst_allocations
+
+QT = core dbus qml testlib
+
+include(../../config.pri)
+
+INCLUDEPATH += ../../lib/core \
+    ../../lib/meta \
+    ../../lib/config
+LIBS += -L../../plugins/debug -lphonebotdebug \
+    -L../../lib/config -lphonebotconfig \
+    -L../../lib/meta -lphonebotmeta \
+    -L../../lib/core -lphonebot
+
+HEADERS += allocationcounter.h
+
+SOURCES += allocationcounter.cpp \
+    tst_allocations.cpp
+
+RESOURCES += res.qrc
+
+OTHER_FILES += \
+    allocationrule.qml
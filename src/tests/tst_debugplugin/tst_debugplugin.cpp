@@ -45,9 +45,10 @@ class DummyCondition: public Condition
     Q_OBJECT
 public:
     explicit DummyCondition(QObject *parent = 0) : Condition(parent) {}
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule)
+        Q_UNUSED(event)
         return true;
     }
 };
@@ -57,7 +58,7 @@ class PongAction: public Action
     Q_OBJECT
 public:
     explicit PongAction(QObject *parent = 0);
-    bool execute(Rule *rule) override;
+    bool execute(Rule *rule, TriggerEvent *event) override;
 Q_SIGNALS:
     void pong();
 };
@@ -67,9 +68,10 @@ PongAction::PongAction(QObject *parent)
 {
 }
 
-bool PongAction::execute(Rule *rule)
+bool PongAction::execute(Rule *rule, TriggerEvent *event)
 {
     Q_UNUSED(rule)
+    Q_UNUSED(event)
     emit pong();
     return true;
 }
@@ -81,19 +83,38 @@ class TstDebugPlugin : public QObject
 private Q_SLOTS:
     void initTestCase();
     void testDebugTrigger();
+    void testStagedReload();
     void cleanupTestCase();
 };
 
 void TstDebugPlugin::initTestCase()
 {
+    PhoneBotEngine::registerTypes();
+    qmlRegisterType<DummyCondition>("org.SfietKonstantin.phonebot.tst_debugplugin", 1, 0, "DummyCondition");
+    qmlRegisterType<PongAction>("org.SfietKonstantin.phonebot.tst_debugplugin", 1, 0, "PongAction");
+}
+
+static PhoneBotEngine * startEngine(const QUrl &source, QObject *parent)
+{
+    PhoneBotEngine *engine = new PhoneBotEngine(parent);
+    QSignalSpy spy(engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    engine->addComponent(source);
+    while (spy.count() < 1) {
+        QTest::qWait(100);
+    }
+    engine->start();
+    return engine;
+}
+
+static PongAction * pongAction(Rule *rule)
+{
+    QQmlListReference actions (rule, "actions");
+    return actions.count() > 0 ? qobject_cast<PongAction *>(actions.at(0)) : 0;
 }
 
 void TstDebugPlugin::testDebugTrigger()
 {
     PhoneBotEngine *engine = new PhoneBotEngine(this);
-    engine->registerTypes();
-    qmlRegisterType<DummyCondition>("org.SfietKonstantin.phonebot.tst_debugplugin", 1, 0, "DummyCondition");
-    qmlRegisterType<PongAction>("org.SfietKonstantin.phonebot.tst_debugplugin", 1, 0, "PongAction");
 
     // Insert component
     QUrl source ("qrc:/debugrule.qml");
@@ -131,6 +152,35 @@ void TstDebugPlugin::testDebugTrigger()
     engine->stop();
 }
 
+void TstDebugPlugin::testStagedReload()
+{
+    // The daemon edits a running rule by starting the new rule in a
+    // staging engine, and then removing the rule it replaces
+    QUrl source ("qrc:/debugrule.qml");
+    PhoneBotEngine *engine = startEngine(source, this);
+    QVERIFY(engine->rule(source));
+    PhoneBotEngine *staging = startEngine(source, this);
+    Rule *stagedRule = staging->rule(source);
+    QVERIFY(stagedRule);
+
+    engine->removeComponent(source);
+    QTest::qWait(100);
+
+    PongAction *action = pongAction(stagedRule);
+    QVERIFY(action);
+    QSignalSpy actionSpy(action, SIGNAL(pong()));
+
+    QDBusInterface interface ("org.SfietKonstantin.phonebotdebug", "/test",
+                              "org.SfietKonstantin.phonebotdebug");
+    QVERIFY(interface.isValid());
+    QDBusMessage message = interface.call("Ping");
+    QCOMPARE(message.type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(actionSpy.count(), 1);
+    staging->stop();
+    engine->deleteLater();
+    staging->deleteLater();
+}
+
 void TstDebugPlugin::cleanupTestCase()
 {
     QTest::qWait(100); // Process delete later
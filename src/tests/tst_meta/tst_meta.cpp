@@ -37,15 +37,18 @@
 #include <phonebotmeta.h>
 #include <phonebotengine.h>
 #include <metatypecache.h>
+#include <nativerulefactory.h>
+#include <rule.h>
 
 class TestCondition: public Condition
 {
     Q_OBJECT
 public:
     explicit TestCondition(QObject *parent = 0) : Condition(parent) { }
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule);
+        Q_UNUSED(event);
         return false;
     }
 };
@@ -56,9 +59,10 @@ class TestCondition2: public Condition
     PHONEBOT_METADATA(MetaTestCondition2)
 public:
     explicit TestCondition2(QObject *parent = 0) : Condition(parent) {}
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule);
+        Q_UNUSED(event);
         return false;
     }
 };
@@ -69,9 +73,10 @@ class TestCondition3: public Condition
     PHONEBOT_METADATA(TestCondition3) // Error: the metadata refers to itself
 public:
     explicit TestCondition3(QObject *parent = 0) : Condition(parent) {}
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule);
+        Q_UNUSED(event);
         return false;
     }
 };
@@ -121,9 +126,10 @@ public:
     {
         Q_UNUSED(test)
     }
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule);
+        Q_UNUSED(event);
         return false;
     }
 signals:
@@ -136,6 +142,8 @@ class TstMeta : public QObject
 private Q_SLOTS:
     void initTestCase();
     void testMeta();
+    void testSharedCache();
+    void testNativeRuleFactory();
     void cleanupTestCase();
 };
 
@@ -167,6 +175,79 @@ void TstMeta::testMeta()
     QCOMPARE(property->type(), MetaProperty::Bool);
 }
 
+void TstMeta::testSharedCache()
+{
+    MetaTypeCache *cache = MetaTypeCache::instance();
+    QVERIFY(cache);
+    QCOMPARE(MetaTypeCache::instance(), cache);
+
+    // Descriptors are built once, and shared
+    AbstractMetaData *testCondition4Meta = cache->metaData("MyTestCondition4");
+    QVERIFY(testCondition4Meta);
+    QCOMPARE(cache->metaData("MyTestCondition4"), testCondition4Meta);
+    MetaProperty *property = testCondition4Meta->property("test");
+    QVERIFY(property);
+    QCOMPARE(testCondition4Meta->property("test"), property);
+}
+
+static QmlDocument::Ptr createDocument(QTemporaryFile &file, const QByteArray &data)
+{
+    if (!file.open()) {
+        return QmlDocument::Ptr();
+    }
+    file.write(data);
+    file.close();
+    return QmlDocument::create(file.fileName());
+}
+
+void TstMeta::testNativeRuleFactory()
+{
+    MetaTypeCache cache;
+
+    QTemporaryFile declarativeFile;
+    QmlDocument::Ptr declarative = createDocument(declarativeFile,
+                                                  "import org.SfietKonstantin.phonebot 1.0\n"
+                                                  "import org.SfietKonstantin.phonebot.tst_meta 1.0\n"
+                                                  "Rule {\n"
+                                                  "    name: \"native\"\n"
+                                                  "    condition: MyTestCondition4 { test: true }\n"
+                                                  "}\n");
+    QVERIFY(!declarative.isNull());
+    QCOMPARE(declarative->error(), QmlDocument::NoError);
+
+    QScopedPointer<NativeRuleFactory> factory (NativeRuleFactory::fromDocument(declarative, &cache));
+    QVERIFY(!factory.isNull());
+    QScopedPointer<Rule> rule (factory->create());
+    QVERIFY(!rule.isNull());
+    QCOMPARE(rule->name(), QString("native"));
+    QVERIFY(qobject_cast<TestCondition4 *>(rule->condition()));
+    QCOMPARE(rule->condition()->parent(), rule.data());
+
+    // Bindings to anything else than a mapper need the QML engine
+    QTemporaryFile bindingFile;
+    QmlDocument::Ptr binding = createDocument(bindingFile,
+                                              "import org.SfietKonstantin.phonebot 1.0\n"
+                                              "import org.SfietKonstantin.phonebot.tst_meta 1.0\n"
+                                              "Rule {\n"
+                                              "    condition: MyTestCondition4 { test: other.value }\n"
+                                              "}\n");
+    QVERIFY(!binding.isNull());
+    QCOMPARE(binding->error(), QmlDocument::NoError);
+    QVERIFY(!NativeRuleFactory::fromDocument(binding, &cache));
+
+    // Literals that don't convert to the property type are left to the QML engine
+    QTemporaryFile mismatchFile;
+    QmlDocument::Ptr mismatch = createDocument(mismatchFile,
+                                               "import org.SfietKonstantin.phonebot 1.0\n"
+                                               "import org.SfietKonstantin.phonebot.tst_meta 1.0\n"
+                                               "Rule {\n"
+                                               "    condition: MyTestCondition4 { test: [true, false] }\n"
+                                               "}\n");
+    QVERIFY(!mismatch.isNull());
+    QCOMPARE(mismatch->error(), QmlDocument::NoError);
+    QVERIFY(!NativeRuleFactory::fromDocument(mismatch, &cache));
+}
+
 void TstMeta::cleanupTestCase()
 {
     QTest::qWait(100); // Process delete later
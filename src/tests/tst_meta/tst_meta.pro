@@ -7,7 +7,7 @@ include(../../config.pri)
 
 INCLUDEPATH += ../../lib/core \
     ../../lib/meta
-LIBS += -L../../lib/core -lphonebot \
-    -L../../lib/meta -lphonebotmeta
+LIBS += -L../../lib/meta -lphonebotmeta \
+    -L../../lib/core -lphonebot
 
 SOURCES += tst_meta.cpp
@@ -201,6 +201,7 @@ void TstParser::testDocument()
     fieldValues << "root" << "reference";
     properties.insert("reference", QVariant::fromValue(Reference::create("parent", fieldValues)));
     properties.insert("string", "My test string");
+    properties.insert("time", QVariant(QTime(8, 30)));
     object->setProperties(properties);
     QString result;
     QTextStream resultStream(&result);
@@ -221,6 +222,7 @@ void TstParser::testDocument()
                  << "    ]" << endl
                  << "    reference: parent.root.reference" << endl
                  << "    string: \"My test string\"" << endl
+                 << "    time: \"08:30\"" << endl
                  << "    Small {" << endl
                  << "    }" << endl
                  << "}" << endl;
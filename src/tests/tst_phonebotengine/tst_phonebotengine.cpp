@@ -35,6 +35,7 @@
 #include <action.h>
 #include <condition.h>
 #include <phonebotengine.h>
+#include <rule.h>
 #include <trigger.h>
 
 class DummyTrigger: public Trigger
@@ -49,9 +50,10 @@ class DummyCondition: public Condition
     Q_OBJECT
 public:
     explicit DummyCondition(QObject *parent = 0) : Condition(parent) {}
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule)
+        Q_UNUSED(event)
         return false;
     }
 };
@@ -61,9 +63,10 @@ class DummyAction: public Action
     Q_OBJECT
 public:
     explicit DummyAction(QObject *parent = 0) : Action(parent) {}
-    bool execute(Rule *rule) override
+    bool execute(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule)
+        Q_UNUSED(event)
         return false;
     }
 };
@@ -75,6 +78,8 @@ private Q_SLOTS:
     void initTestCase();
     void components();
     void rules();
+    void incubatedRules();
+    void hibernatedRules();
     void cleanupTestCase();
 };
 
@@ -198,6 +203,97 @@ void TstPhoneBotEngine::rules()
     QVERIFY(engine.ruleError(sourceDummyRule).isNull());
 }
 
+void TstPhoneBotEngine::incubatedRules()
+{
+    PhoneBotEngine engine;
+    engine.registerTypes();
+    engine.setIncubationBudget(1);
+    QCOMPARE(engine.incubationBudget(), 1);
+
+    QUrl sourceNoRule ("qrc:/no_rule.qml");
+    QUrl sourceDummyRule ("qrc:/dummyrule.qml");
+    engine.addComponent(sourceNoRule);
+    engine.addComponent(sourceDummyRule);
+
+    // Wait
+    QSignalSpy spy(&engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    while (spy.count() != 2) {
+        QTest::qWait(100);
+    }
+
+    // Start, rules are created asynchronously
+    QSignalSpy progressSpy(&engine, SIGNAL(startProgress(int,int)));
+    engine.start();
+    QVERIFY(!engine.isReady());
+    QTRY_VERIFY(engine.isReady());
+
+    QCOMPARE(progressSpy.count(), 2);
+    QList<QVariant> arguments = progressSpy.last();
+    QCOMPARE(arguments.at(0).toInt(), 2);
+    QCOMPARE(arguments.at(1).toInt(), 2);
+
+    QVERIFY(engine.rule(sourceNoRule) == nullptr);
+    QVERIFY(!engine.ruleError(sourceNoRule).isEmpty());
+    QVERIFY(engine.rule(sourceDummyRule) != nullptr);
+    QVERIFY(engine.ruleError(sourceDummyRule).isEmpty());
+
+    engine.stop();
+    QVERIFY(!engine.isReady());
+    QVERIFY(engine.rule(sourceDummyRule) == nullptr);
+
+    // Removing a rule that is still incubating completes the start
+    progressSpy.clear();
+    engine.start();
+    QVERIFY(!engine.isReady());
+    QVERIFY(engine.removeComponent(sourceDummyRule));
+    QTRY_VERIFY(engine.isReady());
+    arguments = progressSpy.last();
+    QCOMPARE(arguments.at(0).toInt(), 2);
+    QCOMPARE(arguments.at(1).toInt(), 2);
+    engine.stop();
+}
+
+void TstPhoneBotEngine::hibernatedRules()
+{
+    PhoneBotEngine engine;
+    engine.registerTypes();
+
+    QUrl source ("qrc:/dummyrule.qml");
+    engine.addComponent(source);
+
+    // Wait
+    QSignalSpy spy(&engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    while (spy.count() != 1) {
+        QTest::qWait(100);
+    }
+
+    engine.start();
+    Rule *rule = engine.rule(source);
+    QVERIFY(rule != nullptr);
+    QVERIFY(!engine.isHibernated(source));
+
+    // Disabling the rule tears it down
+    rule->setName("Hibernated");
+    rule->setEnabled(false);
+    QTRY_VERIFY(engine.isHibernated(source));
+    QVERIFY(engine.rule(source) == nullptr);
+
+    // Enabling it creates it again, with the same properties
+    QVERIFY(engine.setRuleEnabled(source, true));
+    QVERIFY(!engine.isHibernated(source));
+    rule = engine.rule(source);
+    QVERIFY(rule != nullptr);
+    QVERIFY(rule->isEnabled());
+    QCOMPARE(rule->name(), QString("Hibernated"));
+
+    // Disabling through the engine
+    QVERIFY(engine.setRuleEnabled(source, false));
+    QTRY_VERIFY(engine.isHibernated(source));
+
+    engine.stop();
+    QVERIFY(!engine.isHibernated(source));
+}
+
 void TstPhoneBotEngine::cleanupTestCase()
 {
     QTest::qWait(100); // Process delete later
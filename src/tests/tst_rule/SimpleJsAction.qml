@@ -34,7 +34,7 @@ import org.SfietKonstantin.phonebot 1.0
 Action {
     id: container
     signal executed()
-    action: function execute(rule) {
+    action: function execute(rule, event) {
         console.debug(rule)
         container.executed()
         return true
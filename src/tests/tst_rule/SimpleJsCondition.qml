@@ -34,7 +34,7 @@ import org.SfietKonstantin.phonebot 1.0
 Condition {
     id: container
     property bool isCurrentlyValid: false
-    condition: function isValid(rule) {
+    condition: function isValid(rule, event) {
         console.debug(rule)
         isCurrentlyValid = !isCurrentlyValid
         return isCurrentlyValid
@@ -32,23 +32,63 @@
 #include <QtTest/QtTest>
 #include <QtTest/QSignalSpy>
 #include <QtQml/QQmlComponent>
+#include <clock.h>
+#include <clocktimer.h>
+#include <continuationscheduler.h>
+#include <delayaction.h>
+#include <executionjournal.h>
+#include <executionjournalformat.h>
 #include <jsaction.h>
 #include <jscondition.h>
+#include <lazyaction.h>
+#include <mpscqueue.h>
 #include <phonebotengine.h>
 #include <rule.h>
+#include <ruledispatcher.h>
+#include <sequenceaction.h>
 #include <timemapper.h>
+#include <datetimemapper.h>
+#include <durationmapper.h>
+#include <daymaskmapper.h>
 #include <trigger.h>
+#include <triggerevent.h>
+#include <triggeringress.h>
+#include <triggerrecorder.h>
+#include <triggertracereader.h>
+#include <virtualclock.h>
 
 class SimpleTrigger: public Trigger
 {
     Q_OBJECT
 public:
     explicit SimpleTrigger(QObject *parent = 0) : Trigger(parent) {}
-    void sendSignal() {
-        emit triggered();
+    void sendSignal(const QVariantMap &payload = QVariantMap()) {
+        fire(payload);
     }
 };
 
+class PostingThread: public QThread
+{
+    Q_OBJECT
+public:
+    explicit PostingThread(Trigger *trigger, int count, QObject *parent = 0)
+        : QThread(parent), m_trigger(trigger), m_count(count) {}
+protected:
+    void run() override
+    {
+        for (int i = 0; i < m_count; ++i) {
+            QVariantMap payload;
+            payload.insert("index", i);
+            while (!m_trigger->post(payload)) {
+                yieldCurrentThread();
+            }
+        }
+    }
+private:
+    Trigger *m_trigger;
+    int m_count;
+};
+
 class TimeTrigger: public Trigger
 {
     Q_OBJECT
@@ -77,9 +117,10 @@ public:
     void setValid(bool valid) {
         m_valid = valid;
     }
-    bool isValid(Rule *rule) override
+    bool isValid(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule)
+        Q_UNUSED(event)
         return m_valid;
     }
 private:
@@ -90,15 +131,22 @@ class SimpleAction: public Action
 {
     Q_OBJECT
 public:
-    explicit SimpleAction(QObject *parent = 0) : Action(parent) {}
-    bool execute(Rule *rule) override
+    explicit SimpleAction(QObject *parent = 0) : Action(parent), m_lastEvent(0) {}
+    bool execute(Rule *rule, TriggerEvent *event) override
     {
         Q_UNUSED(rule)
+        m_lastEvent = event;
+        m_lastPayload = event ? event->payload() : QVariantMap();
         emit executed();
         return true;
     }
+    TriggerEvent * lastEvent() const { return m_lastEvent; }
+    QVariantMap lastPayload() const { return m_lastPayload; }
 signals:
     void executed();
+private:
+    TriggerEvent *m_lastEvent;
+    QVariantMap m_lastPayload;
 };
 
 class TstRule : public QObject
@@ -109,7 +157,18 @@ private Q_SLOTS:
     void testJs();
     void testDisable();
     void testMapper();
+    void testTypedMappers();
     void testSetTrigger();
+    void testTriggerEvent();
+    void testPolicies();
+    void testDispatcher();
+    void testSequence();
+    void testTriggerIngress();
+    void testScriptWatchdog();
+    void testExecutionJournal();
+    void testTriggerTrace();
+    void testVirtualClock();
+    void testLazyAction();
     void cleanupTestCase();
 };
 
@@ -328,6 +387,551 @@ void TstRule::testMapper()
     QCOMPARE(trigger->time().minute(), mapper->minute());
 }
 
+void TstRule::testTypedMappers()
+{
+    TimeMapper timeMapper;
+    QSignalSpy timeSpy (&timeMapper, SIGNAL(valueChanged()));
+    QVERIFY(!timeMapper.time().isValid());
+    timeMapper.setHour(8);
+    timeMapper.setMinute(30);
+    QCOMPARE(timeMapper.time(), QTime(8, 30));
+    QCOMPARE(timeMapper.value(), QVariant(QTime(8, 30)));
+    QCOMPARE(timeSpy.count(), 1);
+
+    DateTimeMapper dateTimeMapper;
+    dateTimeMapper.setYear(2014);
+    dateTimeMapper.setMonth(7);
+    dateTimeMapper.setDay(14);
+    QVERIFY(!dateTimeMapper.dateTime().isValid());
+    dateTimeMapper.setHour(12);
+    dateTimeMapper.setMinute(0);
+    QCOMPARE(dateTimeMapper.dateTime(), QDateTime(QDate(2014, 7, 14), QTime(12, 0)));
+
+    DurationMapper durationMapper;
+    durationMapper.setMinutes(2);
+    durationMapper.setSeconds(5);
+    QCOMPARE(durationMapper.duration(), 125000);
+
+    DayMaskMapper dayMaskMapper;
+    dayMaskMapper.setDays("1, 3,7");
+    QCOMPARE(dayMaskMapper.mask(), 0x45);
+    dayMaskMapper.setDays("0,8,foo");
+    QCOMPARE(dayMaskMapper.mask(), 0);
+}
+
+void TstRule::testTriggerEvent()
+{
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    QQmlListReference actions (&rule, "actions");
+    SimpleAction action1;
+    SimpleAction action2;
+    actions.append(&action1);
+    actions.append(&action2);
+
+    // All actions see the same event during one firing
+    QVariantMap payload;
+    payload.insert("key", 42);
+    trigger.sendSignal(payload);
+    QVERIFY(action1.lastEvent());
+    QCOMPARE(action1.lastEvent(), action2.lastEvent());
+    QCOMPARE(action1.lastPayload(), payload);
+    QCOMPARE(action2.lastPayload().value("key").toInt(), 42);
+}
+
+void TstRule::testPolicies()
+{
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    QQmlListReference actions (&rule, "actions");
+    SimpleAction action;
+    actions.append(&action);
+    QSignalSpy actionSpy(&action, SIGNAL(executed()));
+
+    // Minimum interval
+    rule.setMinimumInterval(10000);
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QCOMPARE(actionSpy.count(), 1);
+    QCOMPARE(rule.droppedCount(), 1);
+    rule.setMinimumInterval(0);
+
+    // Rate limit
+    actionSpy.clear();
+    rule.setMaxExecutions(2);
+    rule.setExecutionWindow(10000);
+    trigger.sendSignal();
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QCOMPARE(actionSpy.count(), 2);
+    QCOMPARE(rule.droppedCount(), 2);
+    rule.setMaxExecutions(0);
+
+    // Leading debounce
+    actionSpy.clear();
+    rule.setDebounceMode(Rule::Leading);
+    rule.setDebounce(10000);
+    trigger.sendSignal();
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QCOMPARE(actionSpy.count(), 1);
+    QCOMPARE(rule.coalescedCount(), 2);
+
+    // Trailing debounce
+    actionSpy.clear();
+    rule.setDebounceMode(Rule::Trailing);
+    rule.setDebounce(100);
+    QTest::qWait(200);
+    QVariantMap payload;
+    payload.insert("key", 3);
+    trigger.sendSignal();
+    trigger.sendSignal();
+    trigger.sendSignal(payload);
+    QCOMPARE(actionSpy.count(), 0);
+    QTRY_COMPARE(actionSpy.count(), 1);
+    QCOMPARE(rule.coalescedCount(), 4);
+    QCOMPARE(action.lastPayload(), payload);
+    rule.setDebounce(0);
+
+    // Hysteresis
+    actionSpy.clear();
+    rule.setHysteresis(2);
+    trigger.sendSignal();
+    QCOMPARE(actionSpy.count(), 0);
+    trigger.sendSignal();
+    QCOMPARE(actionSpy.count(), 1);
+}
+
+void TstRule::testDispatcher()
+{
+    RuleDispatcher dispatcher;
+    SimpleTrigger trigger;
+    QStringList executed;
+
+    Rule low;
+    low.setTrigger(&trigger);
+    QQmlListReference lowActions (&low, "actions");
+    SimpleAction lowAction;
+    lowActions.append(&lowAction);
+    connect(&lowAction, &SimpleAction::executed, [&executed]() { executed.append("low"); });
+
+    Rule high;
+    high.setPriority(10);
+    high.setTrigger(&trigger);
+    QQmlListReference highActions (&high, "actions");
+    SimpleAction highAction;
+    highActions.append(&highAction);
+    connect(&highAction, &SimpleAction::executed, [&executed]() { executed.append("high"); });
+
+    // Higher priority rules are executed first
+    low.setDispatcher(&dispatcher);
+    high.setDispatcher(&dispatcher);
+    trigger.sendSignal();
+    QCOMPARE(dispatcher.depth(), 2);
+    QVERIFY(executed.isEmpty());
+    QTRY_COMPARE(executed.count(), 2);
+    QCOMPARE(executed, QStringList() << "high" << "low");
+    QCOMPARE(dispatcher.depth(), 0);
+    QVERIFY(dispatcher.maxQueueWait() >= dispatcher.averageQueueWait());
+
+    // Drop oldest, lowest priority entries
+    executed.clear();
+    dispatcher.setMaxDepth(2);
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QCOMPARE(dispatcher.depth(), 2);
+    QCOMPARE(dispatcher.droppedCount(), 2);
+    QTRY_COMPARE(executed.count(), 2);
+    QCOMPARE(executed, QStringList() << "high" << "high");
+
+    // Lower priority entries don't evict higher priority ones
+    executed.clear();
+    dispatcher.resetMetrics();
+    dispatcher.enqueue(&high, nullptr);
+    dispatcher.enqueue(&high, nullptr);
+    dispatcher.enqueue(&low, nullptr);
+    dispatcher.enqueue(&low, nullptr);
+    QCOMPARE(dispatcher.depth(), 2);
+    QCOMPARE(dispatcher.droppedCount(), 2);
+    QTRY_COMPARE(executed.count(), 2);
+    QCOMPARE(executed, QStringList() << "high" << "high");
+
+    // Coalesce entries for a same rule
+    executed.clear();
+    dispatcher.resetMetrics();
+    dispatcher.setOverloadPolicy(RuleDispatcher::CoalescePerRule);
+    QVariantMap payload;
+    payload.insert("key", 1);
+    trigger.sendSignal();
+    trigger.sendSignal(payload);
+    QCOMPARE(dispatcher.depth(), 2);
+    QCOMPARE(dispatcher.coalescedCount(), 2);
+    QCOMPARE(dispatcher.droppedCount(), 0);
+    QTRY_COMPARE(executed.count(), 2);
+    QCOMPARE(lowAction.lastPayload(), payload);
+    QCOMPARE(highAction.lastPayload(), payload);
+
+    // Disabled rules are skipped
+    executed.clear();
+    low.setEnabled(false);
+    trigger.sendSignal();
+    QTRY_COMPARE(executed.count(), 1);
+    QCOMPARE(executed, QStringList() << "high");
+}
+
+void TstRule::testSequence()
+{
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    QQmlListReference actions (&rule, "actions");
+    SequenceAction sequence;
+    actions.append(&sequence);
+
+    QQmlListReference steps (&sequence, "actions");
+    SimpleAction first;
+    DelayAction delay;
+    delay.setDuration(100);
+    SimpleAction second;
+    steps.append(&first);
+    steps.append(&delay);
+    steps.append(&second);
+    QSignalSpy firstSpy(&first, SIGNAL(executed()));
+    QSignalSpy secondSpy(&second, SIGNAL(executed()));
+
+    // The actions after the delay are run later, with the same event
+    QVariantMap payload;
+    payload.insert("key", 1);
+    trigger.sendSignal(payload);
+    QCOMPARE(firstSpy.count(), 1);
+    QCOMPARE(secondSpy.count(), 0);
+    QCOMPARE(ContinuationScheduler::instance()->count(), 1);
+    QTRY_COMPARE(secondSpy.count(), 1);
+    QCOMPARE(second.lastPayload(), payload);
+    QCOMPARE(ContinuationScheduler::instance()->count(), 0);
+
+    // A new execution restarts the sequence
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QCOMPARE(firstSpy.count(), 3);
+    QCOMPARE(ContinuationScheduler::instance()->count(), 1);
+    QTRY_COMPARE(secondSpy.count(), 2);
+
+    // Pending continuations are restored and resumed
+    // when a sequence with the same key is attached
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("continuations.json");
+    QFile file (path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QString("{\"continuations\":[{\"key\":\"qrc:/rule.qml#0\",\"step\":2,"
+                       "\"deadline\":%1,\"timestamp\":%1,\"payload\":{\"key\":2}}]}")
+               .arg(QDateTime::currentMSecsSinceEpoch()).toUtf8());
+    file.close();
+
+    ContinuationScheduler::instance()->setStoragePath(path);
+    QCOMPARE(ContinuationScheduler::instance()->count(), 1);
+    rule.setSource(QUrl("qrc:/rule.qml"));
+    QCOMPARE(sequence.key(), QString("qrc:/rule.qml#0"));
+    QTRY_COMPARE(secondSpy.count(), 3);
+    QCOMPARE(firstSpy.count(), 3);
+    QCOMPARE(second.lastPayload().value("key").toInt(), 2);
+    QCOMPARE(ContinuationScheduler::instance()->count(), 0);
+
+    // Saving is delayed, so that bursts only write once
+    ContinuationScheduler::instance()->flush();
+    trigger.sendSignal();
+    trigger.sendSignal();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(!file.readAll().contains("qrc:/rule.qml#0"));
+    file.close();
+    ContinuationScheduler::instance()->flush();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll().count("qrc:/rule.qml#0"), 1);
+    file.close();
+    QTRY_COMPARE(secondSpy.count(), 4);
+    ContinuationScheduler::instance()->setStoragePath(QString());
+}
+
+void TstRule::testTriggerIngress()
+{
+    // Queue
+    MpscQueue<int> queue (3);
+    QCOMPARE(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(queue.push(i));
+    }
+    QVERIFY(!queue.push(4));
+    int value = -1;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(queue.push(4));
+    for (int i = 1; i < 5; ++i) {
+        QVERIFY(queue.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!queue.pop(value));
+
+    // Events posted from several threads are delivered in the trigger thread
+    SimpleTrigger trigger;
+    int received = 0;
+    bool sameThread = true;
+    connect(&trigger, &Trigger::triggered, [&received, &sameThread, &trigger](TriggerEvent *event) {
+        ++received;
+        sameThread = sameThread && QThread::currentThread() == trigger.thread();
+        QVERIFY(event->payload().contains("index"));
+    });
+
+    TriggerIngress *ingress = TriggerIngress::instance();
+    quint64 drained = ingress->drainedCount();
+    QList<PostingThread *> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.append(new PostingThread(&trigger, 500, this));
+        threads.last()->start();
+    }
+    QTRY_COMPARE(received, 2000);
+    QVERIFY(sameThread);
+    QCOMPARE(ingress->drainedCount() - drained, quint64(2000));
+    for (PostingThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    // Overflow
+    received = 0;
+    quint64 overflow = ingress->overflowCount();
+    QVariantMap payload;
+    payload.insert("index", 0);
+    for (int i = 0; i < ingress->capacity() + 10; ++i) {
+        trigger.post(payload);
+    }
+    QCOMPARE(ingress->overflowCount() - overflow, quint64(10));
+    QTRY_COMPARE(received, ingress->capacity());
+}
+
+void TstRule::testScriptWatchdog()
+{
+    PhoneBotEngine engine;
+    engine.registerTypes();
+
+    QUrl source ("qrc:/slowrule.qml");
+    QSignalSpy spy(&engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    engine.addComponent(source);
+    while (spy.count() < 1) {
+        QTest::qWait(100);
+    }
+
+    engine.start();
+    Rule *rule = engine.rule(source);
+    QVERIFY(rule != nullptr);
+    QCOMPARE(rule->scriptBudget(), 50);
+
+    SimpleTrigger *trigger = qobject_cast<SimpleTrigger *>(rule->trigger());
+    QVERIFY(trigger != nullptr);
+
+    // Each overrun is counted, and the rule is
+    // disabled when it reaches the maximum
+    QSignalSpy exhaustedSpy(rule, SIGNAL(scriptBudgetExhausted()));
+    QElapsedTimer timer;
+    timer.start();
+    trigger->sendSignal();
+    QCOMPARE(rule->scriptOverrunCount(), 1);
+    QVERIFY(rule->isEnabled());
+    QVERIFY(engine.ruleError(source).isEmpty());
+
+    trigger->sendSignal();
+    QCOMPARE(rule->scriptOverrunCount(), 2);
+    QVERIFY(!rule->isEnabled());
+    QCOMPARE(exhaustedSpy.count(), 1);
+    QVERIFY(!engine.ruleError(source).isEmpty());
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    QVERIFY(timer.elapsed() < 400);
+#endif
+
+    // Re-enabling the rule clears the error
+    QTRY_VERIFY(engine.isHibernated(source));
+    QVERIFY(engine.setRuleEnabled(source, true));
+    QVERIFY(engine.ruleError(source).isEmpty());
+}
+
+void TstRule::testExecutionJournal()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("journal.bin");
+    QVERIFY(ExecutionJournal::open(path, 4));
+
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    SimpleCondition condition;
+    rule.setCondition(&condition);
+    QQmlListReference actions (&rule, "actions");
+    SimpleAction action;
+    actions.append(&action);
+    rule.setSource(QUrl("qrc:/journalrule.qml"));
+
+    // Trigger, condition and action are recorded, the
+    // oldest records are overwritten by the newest
+    trigger.sendSignal();
+    condition.setValid(false);
+    trigger.sendSignal();
+    ExecutionJournal::close();
+
+    QFile file (path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray data = file.readAll();
+    const JournalHeader *header = reinterpret_cast<const JournalHeader *>(data.constData());
+    QCOMPARE(header->magic, JOURNAL_MAGIC);
+    QCOMPARE(header->capacity, quint32(4));
+    QCOMPARE(header->writeIndex.load(), quint64(5));
+    QCOMPARE(header->nameSlots, quint32(JOURNAL_NAME_SLOTS));
+    QCOMPARE(header->droppedNames, quint32(0));
+
+    const JournalName *names = reinterpret_cast<const JournalName *>(data.constData() + sizeof(JournalHeader));
+    const JournalRecord *records = reinterpret_cast<const JournalRecord *>(
+                data.constData() + sizeof(JournalHeader) + header->nameSlots * sizeof(JournalName));
+    QList<quint16> kinds;
+    QList<quint16> results;
+    for (quint64 i = 1; i < 5; ++i) {
+        const JournalRecord &record = records[i % 4];
+        QCOMPARE(record.sequence.load(), i + 1);
+        QCOMPARE(QString(names[record.rule % header->nameSlots].name), QString("qrc:/journalrule.qml"));
+        QCOMPARE(record.flags, quint16(0));
+        kinds.append(record.kind);
+        results.append(record.result);
+    }
+    QCOMPARE(kinds, QList<quint16>() << JournalConditionChecked << JournalActionExecuted
+                                     << JournalTriggerFired << JournalConditionChecked);
+    QCOMPARE(results, QList<quint16>() << 1 << 1 << 1 << 0);
+
+    // Names that do not fit in the table are counted once
+    QVERIFY(ExecutionJournal::open(dir.filePath("full.bin"), 4));
+    for (int i = 0; i < JOURNAL_NAME_SLOTS + 10; ++i) {
+        ExecutionJournal::instance()->registerRule(QString("qrc:/rule%1.qml").arg(i));
+    }
+    ExecutionJournal::instance()->registerRule(QString("qrc:/rule%1.qml").arg(JOURNAL_NAME_SLOTS));
+    ExecutionJournal::close();
+
+    QFile fullFile (dir.filePath("full.bin"));
+    QVERIFY(fullFile.open(QIODevice::ReadOnly));
+    data = fullFile.readAll();
+    header = reinterpret_cast<const JournalHeader *>(data.constData());
+    QCOMPARE(header->droppedNames, quint32(10));
+
+    // The table is sized after the number of rules
+    QVERIFY(ExecutionJournal::open(dir.filePath("sized.bin"), 4, JOURNAL_NAME_SLOTS + 10));
+    for (int i = 0; i < JOURNAL_NAME_SLOTS + 10; ++i) {
+        ExecutionJournal::instance()->registerRule(QString("qrc:/rule%1.qml").arg(i));
+    }
+    ExecutionJournal::close();
+
+    QFile sizedFile (dir.filePath("sized.bin"));
+    QVERIFY(sizedFile.open(QIODevice::ReadOnly));
+    data = sizedFile.readAll();
+    header = reinterpret_cast<const JournalHeader *>(data.constData());
+    QCOMPARE(header->nameSlots, quint32(4 * JOURNAL_NAME_SLOTS));
+    QCOMPARE(header->droppedNames, quint32(0));
+}
+
+void TstRule::testTriggerTrace()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("trace.bin");
+    QVERIFY(TriggerRecorder::open(path));
+
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    rule.setSource(QUrl("qrc:/tracerule.qml"));
+
+    // Events of disabled rules are recorded too
+    QVariantMap payload;
+    payload.insert("value", 42);
+    trigger.sendSignal(payload);
+    rule.setEnabled(false);
+    trigger.sendSignal();
+    QCOMPARE(TriggerRecorder::instance()->count(), qint64(2));
+    TriggerRecorder::close();
+
+    TriggerTraceReader reader;
+    QVERIFY(reader.open(path));
+    TriggerTraceEvent event;
+    QVERIFY(reader.readNext(event));
+    QCOMPARE(event.rule, QString("qrc:/tracerule.qml"));
+    QCOMPARE(event.payload, payload);
+    QVERIFY(event.timestamp > 0);
+    QVERIFY(reader.readNext(event));
+    QCOMPARE(event.rule, QString("qrc:/tracerule.qml"));
+    QVERIFY(event.payload.isEmpty());
+    QVERIFY(!reader.readNext(event));
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void TstRule::testVirtualClock()
+{
+    QDateTime start (QDate(2020, 1, 1), QTime(8, 0));
+    VirtualClock clock (start);
+    Clock::setInstance(&clock);
+    QCOMPARE(Clock::instance()->currentDateTime(), start);
+
+    // Repeating timers fire once per interval while advancing
+    ClockTimer timer;
+    timer.setInterval(1000);
+    QSignalSpy timerSpy(&timer, SIGNAL(timeout()));
+    timer.start();
+    clock.advance(3500);
+    QCOMPARE(timerSpy.count(), 3);
+    QCOMPARE(clock.nextTimerDateTime(), start.addMSecs(4000));
+    timer.stop();
+    QCOMPARE(clock.pendingTimerCount(), 0);
+
+    // Repeating timers without interval fire once per pass
+    ClockTimer zeroTimer;
+    QSignalSpy zeroSpy(&zeroTimer, SIGNAL(timeout()));
+    zeroTimer.start(0);
+    clock.advance(0);
+    QCOMPARE(zeroSpy.count(), 1);
+    clock.advance(0);
+    QCOMPARE(zeroSpy.count(), 2);
+    zeroTimer.stop();
+    QCOMPARE(clock.pendingTimerCount(), 0);
+
+    // Debounce deadlines follow the simulated time
+    Rule rule;
+    SimpleTrigger trigger;
+    rule.setTrigger(&trigger);
+    QQmlListReference actions (&rule, "actions");
+    SimpleAction action;
+    actions.append(&action);
+    QSignalSpy actionSpy(&action, SIGNAL(executed()));
+    rule.setDebounce(60000);
+    trigger.sendSignal();
+    clock.advance(59999);
+    QCOMPARE(actionSpy.count(), 0);
+    QVERIFY(clock.advanceToNextTimer());
+    QCOMPARE(actionSpy.count(), 1);
+    QCOMPARE(clock.currentDateTime(), start.addMSecs(3500 + 60000));
+
+    // Events posted from other threads are stamped with the simulated time
+    SimpleTrigger postingTrigger;
+    QDateTime timestamp;
+    connect(&postingTrigger, &Trigger::triggered, [&timestamp](TriggerEvent *event) {
+        timestamp = event->timestamp();
+    });
+    PostingThread postingThread (&postingTrigger, 1);
+    postingThread.start();
+    QVERIFY(postingThread.wait());
+    TriggerIngress::instance()->drain();
+    QCOMPARE(timestamp, clock.currentDateTime());
+
+    Clock::setInstance(nullptr);
+    QVERIFY(!Clock::instance()->isSimulated());
+}
+
 void TstRule::testSetTrigger()
 {
     // Set trigger test
@@ -350,6 +954,46 @@ void TstRule::testSetTrigger()
     QCOMPARE(actionSpy.count(), 2);
 }
 
+void TstRule::testLazyAction()
+{
+    PhoneBotEngine engine;
+    engine.registerTypes();
+
+    // Insert component
+    QUrl source ("qrc:/lazyrule.qml");
+    engine.addComponent(source);
+
+    // Wait
+    QSignalSpy spy(&engine, SIGNAL(componentLoadingFinished(QUrl,bool)));
+    while (spy.count() < 1) {
+        QTest::qWait(100);
+    }
+
+    engine.start();
+    Rule *rule = engine.rule(source);
+    QVERIFY(rule != nullptr);
+
+    SimpleTrigger *trigger = qobject_cast<SimpleTrigger *>(rule->trigger());
+    QVERIFY(trigger != nullptr);
+
+    QQmlListReference actions (rule, "actions");
+    QCOMPARE(actions.count(), 1);
+
+    LazyAction *action = qobject_cast<LazyAction *>(actions.at(0));
+    QVERIFY(action != nullptr);
+
+    // The action is only created when the rule is triggered
+    QVERIFY(action->action() == nullptr);
+    trigger->sendSignal();
+    QVERIFY(action->action() != nullptr);
+    QVERIFY(qobject_cast<SimpleAction *>(action->action()) != nullptr);
+
+    // Then released when idle
+    QTRY_VERIFY(action->action() == nullptr);
+    trigger->sendSignal();
+    QVERIFY(action->action() != nullptr);
+}
+
 void TstRule::cleanupTestCase()
 {
     QTest::qWait(100); // Process delete later
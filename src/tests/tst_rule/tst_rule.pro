@@ -17,5 +17,7 @@ OTHER_FILES += \
     SimpleJsCondition.qml \
     SimpleJsAction.qml \
     simpleactionrule.qml \
-    mapperrule.qml
+    mapperrule.qml \
+    lazyrule.qml \
+    slowrule.qml
 
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2014 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+
+#include <QtTest/QtTest>
+#include <calendarcondition.h>
+#include <timetrigger.h>
+#include <virtualclock.h>
+
+class TstTimePlugin : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTimeWindow();
+    void testDays();
+    void testDates();
+    void testRecompile();
+    void testNextTriggerTime();
+    void testTimeTrigger();
+};
+
+void TstTimePlugin::testTimeWindow()
+{
+    CalendarCondition calendar;
+    QDate date (2020, 1, 6);
+
+    // Without a window, the whole day is active
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(0, 0))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(23, 59))));
+
+    // The end minute is included
+    calendar.setStartTime(QTime(8, 0));
+    calendar.setEndTime(QTime(9, 0));
+    QVERIFY(!calendar.isActiveAt(QDateTime(date, QTime(7, 59))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(8, 0))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(9, 0, 30))));
+    QVERIFY(!calendar.isActiveAt(QDateTime(date, QTime(9, 1))));
+
+    // A window ending before it starts wraps around midnight
+    calendar.setStartTime(QTime(22, 0));
+    calendar.setEndTime(QTime(2, 0));
+    QVERIFY(!calendar.isActiveAt(QDateTime(date, QTime(21, 59))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(22, 0))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(23, 59))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(0, 0))));
+    QVERIFY(calendar.isActiveAt(QDateTime(date, QTime(2, 0))));
+    QVERIFY(!calendar.isActiveAt(QDateTime(date, QTime(2, 1))));
+    QVERIFY(!calendar.isActiveAt(QDateTime(date, QTime(12, 0))));
+}
+
+void TstTimePlugin::testDays()
+{
+    CalendarCondition calendar;
+
+    // Days of the week, within the from / to range
+    calendar.setDays("1,3");
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 6)));
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 7)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 8)));
+
+    calendar.setFrom("2020-01-08");
+    calendar.setTo("2020-01-13");
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 6)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 8)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 13)));
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 15)));
+
+    // Excluded dates win over the days
+    calendar.setExcludedDates("2020-01-13");
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 8)));
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 13)));
+}
+
+void TstTimePlugin::testDates()
+{
+    CalendarCondition calendar;
+    calendar.setDays("1");
+    calendar.setFrom("2020-01-01");
+    calendar.setTo("2020-01-31");
+
+    // Explicit dates take precedence over the days and the range
+    calendar.setDates("2020-01-08, 2020-02-12");
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 6)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 8)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 2, 12)));
+
+    // Exclusions still apply
+    calendar.setExcludedDates("2020-01-08");
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 8)));
+    QCOMPARE(calendar.nextActiveDate(QDate(2020, 1, 1)), QDate(2020, 2, 12));
+}
+
+void TstTimePlugin::testRecompile()
+{
+    CalendarCondition calendar;
+    calendar.setDays("6");
+
+    // Queries outside of the compiled year recompile it,
+    // forward and backward
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 4)));
+    QVERIFY(calendar.isActiveOn(QDate(2021, 6, 5)));
+    QVERIFY(!calendar.isActiveOn(QDate(2021, 6, 6)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 11)));
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 10)));
+    QCOMPARE(calendar.nextActiveDate(QDate(2020, 12, 27)), QDate(2021, 1, 2));
+
+    // Changing a property invalidates the compiled year
+    calendar.setDays("7");
+    QVERIFY(!calendar.isActiveOn(QDate(2020, 1, 11)));
+    QVERIFY(calendar.isActiveOn(QDate(2020, 1, 12)));
+}
+
+void TstTimePlugin::testNextTriggerTime()
+{
+    VirtualClock clock (QDateTime(QDate(2020, 1, 6), QTime(8, 0)));
+    Clock::setInstance(&clock);
+
+    TimeTrigger trigger;
+    trigger.setTime(QTime(9, 0));
+    QCOMPARE(trigger.nextTriggerTime(), QDateTime(QDate(2020, 1, 6), QTime(9, 0)));
+    trigger.setTime(QTime(7, 0));
+    QCOMPARE(trigger.nextTriggerTime(), QDateTime(QDate(2020, 1, 7), QTime(7, 0)));
+
+    // Days that are not active in the calendar are skipped
+    CalendarCondition calendar;
+    calendar.setDays("3");
+    trigger.setCalendar(&calendar);
+    QCOMPARE(trigger.nextTriggerTime(), QDateTime(QDate(2020, 1, 8), QTime(7, 0)));
+    calendar.setExcludedDates("2020-01-08");
+    QCOMPARE(trigger.nextTriggerTime(), QDateTime(QDate(2020, 1, 15), QTime(7, 0)));
+
+    // No active day, no trigger
+    calendar.setDates("2019-12-25");
+    QVERIFY(!trigger.nextTriggerTime().isValid());
+
+    trigger.setCalendar(nullptr);
+    Clock::setInstance(nullptr);
+}
+
+void TstTimePlugin::testTimeTrigger()
+{
+    // Saturday
+    VirtualClock clock (QDateTime(QDate(2020, 1, 4), QTime(8, 0)));
+    Clock::setInstance(&clock);
+
+    TimeTrigger trigger;
+    trigger.setTime(QTime(9, 0));
+    CalendarCondition calendar;
+    calendar.setDays("1,2,3,4,5");
+    trigger.setCalendar(&calendar);
+    QList<QDateTime> fired;
+    connect(&trigger, &Trigger::triggered, [&fired, &clock]() {
+        fired.append(clock.currentDateTime());
+    });
+
+    // Only fired on week days, once per day
+    clock.advanceTo(QDateTime(QDate(2020, 1, 7), QTime(12, 0)));
+    QCOMPARE(fired.count(), 2);
+    QCOMPARE(fired.at(0), QDateTime(QDate(2020, 1, 6), QTime(9, 0)));
+    QCOMPARE(fired.at(1), QDateTime(QDate(2020, 1, 7), QTime(9, 0)));
+
+    // Passive triggers only fire when asked to
+    trigger.setPassive(true);
+    clock.advanceTo(QDateTime(QDate(2020, 1, 9), QTime(12, 0)));
+    QCOMPARE(fired.count(), 2);
+
+    trigger.setCalendar(nullptr);
+    Clock::setInstance(nullptr);
+}
+
+QTEST_MAIN(TstTimePlugin)
+
+#include "tst_timeplugin.moc"
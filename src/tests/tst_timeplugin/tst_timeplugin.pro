@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = tst_timeplugin
+
+QT = core dbus qml testlib
+
+include(../../config.pri)
+
+INCLUDEPATH += ../../lib/core \
+    ../../lib/meta \
+    ../../plugins/time
+LIBS += -L../../plugins/time -lphonebottime \
+    -L../../lib/nemomw -lnemomw \
+    -L../../lib/meta -lphonebotmeta \
+    -L../../lib/core -lphonebot
+
+include(../../3rdparty/libnemomw/keepalive/keepalive-deps.pri)
+
+SOURCES += tst_timeplugin.cpp
@@ -0,0 +1,24 @@
+#!/bin/bash
+# Measures phonebotd against generated rule sets of increasing size
+#
+# Usage: run-load.sh [phonebot-rulegen options]
+# Example: run-load.sh --triggers TimeTrigger=3,DebugTrigger=1 --actions-per-rule 1-3
+#
+# Each run uses a private bus with the stand-in system services,
+# and prints the metrics of phonebot-loaddriver as JSON.
+ROOTDIR=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+RULEGEN=${RULEGEN:-$ROOTDIR/../src/bin/rulegen/phonebot-rulegen}
+LOADDRIVER=${LOADDRIVER:-$ROOTDIR/../src/bin/loaddriver/phonebot-loaddriver}
+DAEMON=${DAEMON:-$ROOTDIR/../src/bin/daemon/phonebotd}
+SIZES=${SIZES:-"10 100 1000 10000"}
+SEED=${SEED:-1}
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+for SIZE in $SIZES; do
+    RULES=$WORKDIR/rules-$SIZE
+    "$RULEGEN" --count "$SIZE" --seed "$SEED" "$@" "$RULES" >/dev/null || exit 1
+    echo "# $SIZE rules"
+    "$ROOTDIR/run-standin.sh" -- "$LOADDRIVER" --daemon "$DAEMON" --json "$RULES" || exit 1
+done
@@ -0,0 +1,57 @@
+#!/bin/bash
+# Runs a command against the stand-in system services, on a private bus
+#
+# Usage: run-standin.sh [phonebot-standin options] -- command [arguments]
+# Example: run-standin.sh --latency 20 --jitter 10 --failure-rate 0.01 -- phonebotd
+#
+# The private bus is used as both the session and the system bus, since
+# libconnman-qt talks to connman on the system bus.
+ROOTDIR=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+STANDIN=${STANDIN:-$ROOTDIR/../src/bin/standin/phonebot-standin}
+
+STANDIN_ARGS=()
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    STANDIN_ARGS+=("$1")
+    shift
+done
+if [ "$1" != "--" ] || [ $# -lt 2 ]; then
+    echo "Usage: $0 [phonebot-standin options] -- command [arguments]" >&2
+    exit 2
+fi
+shift
+
+BUS_ADDRESS=$(dbus-daemon --session --fork --print-address=1 --print-pid=3 3>/tmp/phonebot-standin-bus.$$)
+if [ -z "$BUS_ADDRESS" ]; then
+    echo "Failed to start a private bus" >&2
+    exit 1
+fi
+BUS_PID=$(cat /tmp/phonebot-standin-bus.$$)
+rm -f /tmp/phonebot-standin-bus.$$
+
+export DBUS_SESSION_BUS_ADDRESS=$BUS_ADDRESS
+export DBUS_SYSTEM_BUS_ADDRESS=$BUS_ADDRESS
+
+"$STANDIN" "${STANDIN_ARGS[@]}" &
+STANDIN_PID=$!
+
+cleanup() {
+    kill $STANDIN_PID 2>/dev/null
+    kill $BUS_PID 2>/dev/null
+}
+trap cleanup EXIT
+
+# Wait for the stand-ins to be registered
+for i in $(seq 50); do
+    if dbus-send --session --print-reply --dest=org.freedesktop.DBus / \
+        org.freedesktop.DBus.NameHasOwner string:org.SfietKonstantin.phonebot.standin \
+        2>/dev/null | grep -q "true"; then
+        break
+    fi
+    if ! kill -0 $STANDIN_PID 2>/dev/null; then
+        echo "phonebot-standin exited" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+
+"$@"